@@ -0,0 +1,186 @@
+// advice_cache.cpp
+#include "advice_cache.h"
+#include "cache_file.h"
+#include "logger.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+using json = nlohmann::json;
+
+namespace {
+
+const int CACHE_VERSION = 1;
+
+} // namespace
+
+int adviceDayPart(time_t when) {
+    std::tm local;
+    localtime_r(&when, &local);
+    return local.tm_hour / 6;
+}
+
+AdviceKey makeAdviceKey(double temperature, int weathercode, double windspeed, time_t when,
+                        const std::string& language) {
+    return AdviceKey{
+        static_cast<int>(std::round(temperature)),
+        weathercode,
+        static_cast<int>(std::round(windspeed)),
+        adviceDayPart(when),
+        language
+    };
+}
+
+AdviceCache::AdviceCache(const std::string& path, size_t maxEntries, int ttlSeconds)
+    : path(path), maxEntries(std::max<size_t>(1, maxEntries)), ttlSeconds(ttlSeconds),
+      generation(0), writtenGeneration(0)
+{
+}
+
+bool AdviceCache::isFresh(const Entry& entry, time_t now) const {
+    return now - entry.created <= ttlSeconds;
+}
+
+void AdviceCache::load(time_t now) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return;
+    }
+    json data = json::parse(in, nullptr, false);
+    if (!data.is_object() || data.value("version", 0) != CACHE_VERSION || !data.contains("entries") ||
+        !data["entries"].is_array()) {
+        LOG_WARNING("Ignoring malformed advice cache %s", path.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    for (const auto& item : data["entries"]) {
+        try {
+            Entry entry{
+                AdviceKey{
+                    item.at("temperature").get<int>(),
+                    item.at("weathercode").get<int>(),
+                    item.at("windspeed").get<int>(),
+                    item.at("dayPart").get<int>(),
+                    item.at("language").get<std::string>()
+                },
+                item.at("advice").get<std::string>(),
+                static_cast<time_t>(item.at("created").get<long long>())
+            };
+            if (isFresh(entry, now) && !entry.advice.empty()) {
+                entries.push_back(std::move(entry));
+            }
+        } catch (const std::exception& e) {
+            LOG_DEBUG("Skipping malformed advice cache entry: %s", e.what());
+        }
+    }
+    LOG_INFO("Loaded %zu cached advice entries", entries.size());
+}
+
+const AdviceCache::Entry* AdviceCache::findLocked(const AdviceKey& key, time_t now) const {
+    for (const Entry& entry : entries) {
+        if (entry.key == key && isFresh(entry, now)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool AdviceCache::lookup(const AdviceKey& key, time_t now, std::string& advice) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    AdviceKey probe = key;
+    for (int delta : {0, -1, 1}) {
+        probe.temperature = key.temperature + delta;
+        if (const Entry* entry = findLocked(probe, now)) {
+            advice = entry->advice;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AdviceCache::contains(const AdviceKey& key, time_t now) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return findLocked(key, now) != nullptr;
+}
+
+void AdviceCache::store(const AdviceKey& key, const std::string& advice, time_t now) {
+    store(std::vector<Item>{{key, advice}}, now);
+}
+
+void AdviceCache::store(const std::vector<Item>& items, time_t now) {
+    if (items.empty()) {
+        return;
+    }
+    std::string contents;
+    uint64_t snapshotGeneration;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry& e) {
+                          if (!isFresh(e, now)) return true;
+                          for (const Item& item : items) {
+                              if (e.key == item.key) return true;
+                          }
+                          return false;
+                      }),
+                      entries.end());
+        for (const Item& item : items) {
+            entries.push_back(Entry{item.key, item.advice, now});
+        }
+
+        // Oldest first in the vector, since entries are appended as they are made
+        if (entries.size() > maxEntries) {
+            entries.erase(entries.begin(), entries.begin() + (entries.size() - maxEntries));
+        }
+        contents = serializeLocked();
+        snapshotGeneration = ++generation;
+    }
+    save(contents, snapshotGeneration);
+}
+
+bool AdviceCache::latest(const std::string& language, time_t now, std::string& advice) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (it->key.language == language && isFresh(*it, now)) {
+            advice = it->advice;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t AdviceCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+std::string AdviceCache::serializeLocked() const {
+    json list = json::array();
+    for (const Entry& entry : entries) {
+        list.push_back({
+            {"temperature", entry.key.temperature},
+            {"weathercode", entry.key.weathercode},
+            {"windspeed", entry.key.windspeed},
+            {"dayPart", entry.key.dayPart},
+            {"language", entry.key.language},
+            {"advice", entry.advice},
+            {"created", static_cast<long long>(entry.created)}
+        });
+    }
+    json data = {{"version", CACHE_VERSION}, {"entries", std::move(list)}};
+    return data.dump();
+}
+
+bool AdviceCache::save(const std::string& contents, uint64_t snapshotGeneration) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (snapshotGeneration <= writtenGeneration) {
+        return true; // A concurrent store already wrote a newer snapshot
+    }
+    if (!writeFileAtomically(path, contents)) {
+        return false;
+    }
+    writtenGeneration = snapshotGeneration;
+    return true;
+}
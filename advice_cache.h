@@ -0,0 +1,88 @@
+// advice_cache.h
+#ifndef ADVICE_CACHE_H
+#define ADVICE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Advice is the same for the same rounded weather at the same time of day, so
+// it is memoized under the WeatherKey rounding plus a day part and language
+struct AdviceKey {
+    int temperature;   // Rounded °C
+    int weathercode;
+    int windspeed;     // Rounded m/s
+    int dayPart;       // See adviceDayPart()
+    std::string language;
+
+    bool operator==(const AdviceKey& other) const {
+        return temperature == other.temperature && weathercode == other.weathercode &&
+               windspeed == other.windspeed && dayPart == other.dayPart && language == other.language;
+    }
+};
+
+// Local time of day bucket: 0 night (0-5 h), 1 morning, 2 afternoon, 3 evening (18-23 h)
+int adviceDayPart(time_t when);
+AdviceKey makeAdviceKey(double temperature, int weathercode, double windspeed, time_t when,
+                        const std::string& language);
+
+// Small persistent advice store: a JSON file rewritten (temp file + rename)
+// on every store. Entries older than ttlSeconds are ignored and dropped; past
+// maxEntries the oldest go first. Thread-safe; the file is written outside
+// the entry lock, so lookups from the render thread never wait on disk.
+class AdviceCache {
+public:
+    AdviceCache(const std::string& path, size_t maxEntries, int ttlSeconds);
+
+    // Read the file; a missing or malformed file leaves the cache empty
+    void load(time_t now);
+
+    // Fresh advice for key. A neighbouring temperature (±1 °C) counts as a
+    // hit too: the advice does not change at that step, and it lets forecast
+    // prefetches match the observed weather.
+    bool lookup(const AdviceKey& key, time_t now, std::string& advice) const;
+
+    // Exact fresh entry present (prefetch skips these)
+    bool contains(const AdviceKey& key, time_t now) const;
+
+    struct Item {
+        AdviceKey key;
+        std::string advice;
+    };
+
+    void store(const AdviceKey& key, const std::string& advice, time_t now);
+    // Insert all items, then write the file once
+    void store(const std::vector<Item>& items, time_t now);
+
+    // Newest fresh advice in this language, shown at boot before any weather arrives
+    bool latest(const std::string& language, time_t now, std::string& advice) const;
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        AdviceKey key;
+        std::string advice;
+        time_t created;
+    };
+
+    std::string path;
+    size_t maxEntries;
+    int ttlSeconds;
+    std::vector<Entry> entries;   // A few hundred at most; scanned linearly
+    uint64_t generation;          // Bumped by every store, so an older snapshot never overwrites a newer one
+    mutable std::mutex mutex;     // Guards entries and generation
+
+    std::mutex fileMutex;         // Serializes file writes
+    uint64_t writtenGeneration;   // Newest snapshot on disk; guarded by fileMutex
+
+    bool isFresh(const Entry& entry, time_t now) const;
+    const Entry* findLocked(const AdviceKey& key, time_t now) const;
+    std::string serializeLocked() const;
+    bool save(const std::string& contents, uint64_t snapshotGeneration);
+};
+
+#endif // ADVICE_CACHE_H
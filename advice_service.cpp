@@ -0,0 +1,359 @@
+// advice_service.cpp
+#include "advice_service.h"
+#include "clothing_advice.h"
+#include "constants.h"
+#include "logger.h"
+#include "http_client.h"
+#include "io_executor.h"
+#include "metrics.h"
+#include "config.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// The weather request asks for ADVICE_PREFETCH_HOURS + 1 hourly entries
+static_assert(ADVICE_PREFETCH_HOURS + 1 <= HourlyForecast::CAPACITY,
+              "HourlyForecast cannot hold the prefetch window");
+
+namespace {
+
+bool hasApiKey() {
+    return CEREBRAS_API_KEY && std::strlen(CEREBRAS_API_KEY) > 0;
+}
+
+} // namespace
+
+AdviceService::AdviceService(IOExecutor& executor, const char* language)
+    : language(language ? language : "ru")
+    , executor(executor)
+    , running(false)
+    , jobQueued(false)
+    , drainJob(0)
+    , hasPendingRequest(false)
+    , pendingKey{0, -1, 0, true}
+    , pendingTime(0)
+    , pendingGeneration(0)
+    , hasPendingPrefetch(false)
+    , lastPrefetch(0)
+    , requestInFlight(false)
+    , inFlightKey{0, -1, 0, true}
+    , inFlightGeneration(0)
+    , adviceGeneration(0)
+    , requestActive(false)
+    , httpClient(HTTPClient::forHost(CEREBRAS_API_HOST, CEREBRAS_API_PORT))
+    , cache(ADVICE_CACHE_PATH, ADVICE_CACHE_ENTRIES, ADVICE_CACHE_TTL_SECONDS)
+    , hasNewAdvice(false)
+{
+    cache.load(std::time(nullptr));
+}
+
+AdviceService::~AdviceService() {
+    stop();
+}
+
+void AdviceService::start() {
+    if (!running.exchange(true)) {
+        LOG_INFO("AdviceService started");
+    }
+}
+
+void AdviceService::stop() {
+    if (running.exchange(false)) {
+        bool cancelJob;
+        uint64_t job;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            hasPendingRequest = false;
+            hasPendingPrefetch = false;
+            // Abort the blocking POST instead of waiting out its timeouts
+            if (requestActive) {
+                LOG_DEBUG("Aborting in-flight advice request");
+                httpClient->abort();
+            }
+            cancelJob = jobQueued;
+            job = drainJob;
+        }
+        // Outside the lock: the job needs it to finish
+        if (cancelJob) {
+            executor.cancel(job);
+        }
+        LOG_INFO("AdviceService stopped");
+    }
+}
+
+WeatherKey AdviceService::makeKey(const WeatherData& weather) {
+    return WeatherKey{
+        static_cast<int>(std::round(weather.temperature)),
+        weather.weathercode,
+        static_cast<int>(std::round(weather.windspeed)),
+        true
+    };
+}
+
+void AdviceService::requestAdvice(const WeatherData& weather) {
+    WeatherKey key = makeKey(weather);
+    const time_t now = std::time(nullptr);
+
+    std::string cached;
+    if (running && cache.lookup(makeAdviceKey(weather.temperature, weather.weathercode, weather.windspeed,
+                                              now, language), now, cached)) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            hasPendingRequest = false; // Superseded: it was for older weather
+            ++adviceGeneration;        // So is a request in flight
+            latestAdvice = std::move(cached);
+            hasNewAdvice = true;
+        }
+        LOG_DEBUG("Clothing advice served from cache");
+        if (onResult) onResult();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running) {
+        return;
+    }
+    if (hasPendingRequest && pendingKey == key) {
+        LOG_DEBUG("Advice request for same weather already queued, skipping");
+        return;
+    }
+    if (requestInFlight && inFlightKey == key) {
+        // The weather went back to what is being fetched: that answer is
+        // current again, and anything queued after it is not
+        LOG_DEBUG("Advice request for same weather already in progress, skipping");
+        hasPendingRequest = false;
+        inFlightGeneration = ++adviceGeneration;
+        return;
+    }
+    pendingWeather = weather;
+    pendingKey = key;
+    pendingTime = now;
+    pendingGeneration = ++adviceGeneration;
+    hasPendingRequest = true;
+    postDrainLocked();
+}
+
+void AdviceService::prefetchForecast(const WeatherData& weather) {
+    const time_t now = std::time(nullptr);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running || weather.hourly.conditionsCount == 0 ||
+        (lastPrefetch != 0 && now - lastPrefetch < ADVICE_PREFETCH_INTERVAL_SECONDS)) {
+        return;
+    }
+    pendingForecast = weather.hourly;
+    hasPendingPrefetch = true;
+    lastPrefetch = now;
+    postDrainLocked();
+}
+
+bool AdviceService::getCachedAdvice(std::string& advice) const {
+    return cache.latest(language, std::time(nullptr), advice);
+}
+
+void AdviceService::postDrainLocked() {
+    // A running drain job picks new work up itself
+    if (!jobQueued) {
+        jobQueued = true;
+        drainJob = executor.post([this]() { drainRequests(); });
+    }
+}
+
+bool AdviceService::pollAdvice(std::string& advice) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!hasNewAdvice) {
+        return false;
+    }
+    advice = std::move(latestAdvice);
+    latestAdvice.clear();
+    hasNewAdvice = false;
+    return true;
+}
+
+bool AdviceService::isBusy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hasPendingRequest || requestInFlight;
+}
+
+bool AdviceService::postCompletion(const std::string& payload, std::string& body) {
+    httplib::Headers headers = {
+        {"Authorization", std::string("Bearer ") + CEREBRAS_API_KEY},
+    };
+
+    // Mark the request active so stop() can abort it
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return false;
+        }
+        requestActive = true;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    auto res = httpClient->post(CEREBRAS_API_PATH, payload, "application/json", headers, 10);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requestActive = false;
+    }
+
+    if (!running) {
+        return false; // Cancelled during shutdown
+    }
+    Metrics::instance().recordRequest(RequestKind::ADVICE, elapsed, res.statusCode == 200);
+
+    if (res.statusCode == 200) {
+        body = std::move(res.body);
+        return true;
+    }
+    if (res.statusCode != 0) {
+        LOG_ERROR("Cerebras API returned status %d", res.statusCode);
+    } else {
+        LOG_ERROR("HTTP request failed: %s", res.error.c_str());
+    }
+    return false;
+}
+
+std::string AdviceService::fetchAdvice(const WeatherData& weather, bool& fromModel) {
+    fromModel = false;
+    if (!hasApiKey()) {
+        LOG_WARNING("Cerebras API Key is not configured. Falling back to basic advice.");
+        return getBasicAdvice(weather.temperature);
+    }
+
+    std::string payload = buildClothingAdvicePayload(
+        weather.temperature, weather.weathercode, weather.windspeed, language.c_str());
+
+    std::string body;
+    if (postCompletion(payload, body)) {
+        return parseClothingAdviceResponse(body, weather.temperature, &fromModel);
+    }
+    if (!running) {
+        return "";
+    }
+    return getBasicAdvice(weather.temperature);
+}
+
+void AdviceService::runPrefetch(const HourlyForecast& forecast) {
+    if (!hasApiKey() || forecast.startTime == 0) {
+        return;
+    }
+
+    // The coming hours whose advice is not cached yet, one slot per distinct key
+    const time_t now = std::time(nullptr);
+    const time_t horizon = now + static_cast<time_t>(ADVICE_PREFETCH_HOURS) * 3600;
+    std::vector<AdviceForecastSlot> slots;
+    std::vector<AdviceKey> keys;
+    for (int i = 0; i < forecast.conditionsCount; ++i) {
+        const time_t when = forecast.startTime + static_cast<time_t>(i) * 3600;
+        if (when <= now) continue;
+        if (when > horizon) break;
+        if (std::isnan(forecast.temperature[i]) || std::isnan(forecast.windspeed[i]) ||
+            forecast.weathercode[i] < 0) {
+            continue;
+        }
+        AdviceKey key = makeAdviceKey(forecast.temperature[i], forecast.weathercode[i],
+                                      forecast.windspeed[i], when, language);
+        if (cache.contains(key, now) || std::find(keys.begin(), keys.end(), key) != keys.end()) {
+            continue;
+        }
+        keys.push_back(std::move(key));
+        const bool haveFeel = i < forecast.count; // NaN entries are skipped by the prompt
+        slots.push_back({when, forecast.temperature[i], forecast.weathercode[i], forecast.windspeed[i],
+                         haveFeel ? forecast.apparentTemperature[i] : std::nan(""),
+                         haveFeel ? forecast.precipitation[i] : std::nan("")});
+    }
+    if (slots.empty()) {
+        LOG_DEBUG("Forecast advice already cached");
+        return;
+    }
+
+    std::vector<AdviceCache::Item> fetched;
+    for (size_t first = 0; first < slots.size(); first += ADVICE_PREFETCH_BATCH) {
+        {
+            // A real request goes first; what is left is retried next interval
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running || hasPendingRequest) {
+                break;
+            }
+        }
+
+        const size_t last = std::min(slots.size(), first + ADVICE_PREFETCH_BATCH);
+        std::vector<AdviceForecastSlot> batch(slots.begin() + first, slots.begin() + last);
+        std::string body;
+        std::vector<std::string> advice;
+        if (!postCompletion(buildClothingAdviceBatchPayload(batch, language.c_str()), body) ||
+            !parseClothingAdviceBatchResponse(body, batch.size(), advice)) {
+            LOG_WARNING("Forecast advice prefetch failed");
+            break;
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            fetched.push_back({keys[first + i], std::move(advice[i])});
+        }
+    }
+    if (!fetched.empty()) {
+        // One insert and one file write for the whole run
+        cache.store(fetched, std::time(nullptr));
+        LOG_INFO("Prefetched clothing advice for %zu forecast hours", fetched.size());
+    }
+}
+
+void AdviceService::drainRequests() {
+    while (true) {
+        WeatherData weather;
+        time_t requested = 0;
+        bool prefetch = false;
+        HourlyForecast forecast;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (running && !hasPendingRequest && hasPendingPrefetch) {
+                // Only when no request waits: prefetching is opportunistic
+                forecast = pendingForecast;
+                hasPendingPrefetch = false;
+                prefetch = true;
+            } else if (!running || !hasPendingRequest) {
+                jobQueued = false;
+                return;
+            } else {
+                weather = pendingWeather;
+                requested = pendingTime;
+                inFlightKey = pendingKey;
+                inFlightGeneration = pendingGeneration;
+                hasPendingRequest = false;
+                requestInFlight = true;
+            }
+        }
+        if (prefetch) {
+            runPrefetch(forecast);
+            continue;
+        }
+
+        LOG_DEBUG("Fetching clothing advice in background");
+        bool fromModel = false;
+        std::string advice = fetchAdvice(weather, fromModel);
+        if (fromModel) {
+            // Fallback advice is not cached, so the model is asked again next time
+            cache.store(makeAdviceKey(weather.temperature, weather.weathercode, weather.windspeed,
+                                      requested, language), advice, std::time(nullptr));
+        }
+
+        bool delivered = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requestInFlight = false;
+            if (inFlightGeneration != adviceGeneration) {
+                // Newer weather was answered (or queued) meanwhile; the
+                // result is still cached above for its own weather
+                LOG_DEBUG("Dropping clothing advice for superseded weather");
+            } else if (running && !advice.empty()) {
+                latestAdvice = std::move(advice);
+                hasNewAdvice = true;
+                delivered = true;
+                LOG_INFO("Clothing advice updated");
+            }
+        }
+        if (delivered && onResult) onResult();
+    }
+}
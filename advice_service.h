@@ -0,0 +1,105 @@
+// advice_service.h
+#ifndef ADVICE_SERVICE_H
+#define ADVICE_SERVICE_H
+
+#include "advice_cache.h"
+#include "weather.h"
+#include "weather_api.h"
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+class HTTPClient;
+class IOExecutor;
+
+// Fetches clothing advice on the shared I/O executor so the render loop never
+// blocks on the LLM. The main loop submits requests and polls for results;
+// the last advice keeps being shown until a new one arrives.
+//
+// Model answers are kept in a persistent AdviceCache, so unchanged weather
+// (and a restart) costs no request. When the drain job has nothing else to do
+// it prefetches advice for the coming forecast hours, several per request.
+class AdviceService {
+public:
+    explicit AdviceService(IOExecutor& executor, const char* language = "ru");
+    ~AdviceService();
+
+    // Control methods
+    void start();
+    void stop();   // Aborts an in-flight request and waits for the job to return
+
+    // Non-blocking: queue advice generation for the given weather. Cached advice
+    // is delivered at once, without a request. A request for the same rounded
+    // weather as the one in flight or already queued is dropped; a different
+    // one replaces the queued request.
+    void requestAdvice(const WeatherData& weather);
+
+    // Non-blocking: prepare advice for the next ADVICE_PREFETCH_HOURS of
+    // weather.hourly once queued requests are served. At most once per
+    // ADVICE_PREFETCH_INTERVAL_SECONDS; hours already cached are skipped.
+    void prefetchForecast(const WeatherData& weather);
+
+    // Newest cached advice, to show before the first weather update
+    bool getCachedAdvice(std::string& advice) const;
+
+    // Non-blocking: returns true and moves the result out if new advice arrived
+    // since the last call
+    bool pollAdvice(std::string& advice);
+
+    // True while a request is queued or in flight
+    bool isBusy() const;
+
+    // Called from an executor thread when new advice is ready. Set before start().
+    void setResultCallback(std::function<void()> callback) { onResult = std::move(callback); }
+
+private:
+    std::string language;
+
+    // Job control
+    IOExecutor& executor;
+    std::atomic<bool> running;
+    mutable std::mutex mutex; // Protects everything below
+    bool jobQueued;           // A drain job is posted or running
+    uint64_t drainJob;
+
+    // Request state
+    bool hasPendingRequest;
+    WeatherData pendingWeather;
+    WeatherKey pendingKey;
+    time_t pendingTime;                     // When the request was made (day part of its cache key)
+    uint64_t pendingGeneration;
+    bool hasPendingPrefetch;
+    HourlyForecast pendingForecast;
+    time_t lastPrefetch;
+    bool requestInFlight;
+    WeatherKey inFlightKey;
+    uint64_t inFlightGeneration;
+    // Bumped for every requestAdvice() that changes what should be shown; a
+    // finished request is delivered only if it is still the current one
+    uint64_t adviceGeneration;
+    bool requestActive;                     // POST on httpClient in progress; stop() aborts it
+    std::shared_ptr<HTTPClient> httpClient; // Pooled per-host client
+    AdviceCache cache;                      // Thread-safe itself
+
+    // Result state
+    bool hasNewAdvice;
+    std::string latestAdvice;
+    std::function<void()> onResult;
+
+    // Internal methods
+    void drainRequests();  // Executor job: serves queued requests, then a queued prefetch
+    void postDrainLocked();
+    bool postCompletion(const std::string& payload, std::string& body);  // One Cerebras call
+    std::string fetchAdvice(const WeatherData& weather, bool& fromModel);
+    void runPrefetch(const HourlyForecast& forecast);
+    static WeatherKey makeKey(const WeatherData& weather);
+
+    // Prevent copying
+    AdviceService(const AdviceService&) = delete;
+    AdviceService& operator=(const AdviceService&) = delete;
+};
+
+#endif // ADVICE_SERVICE_H
@@ -0,0 +1,15 @@
+// alloc_counter.h
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+// Process-wide counts of operator new calls (all threads), from the global
+// replacements in alloc_counter.cpp. Used by the headless replay report.
+// Only counted in builds configured with CLOCK_COUNT_ALLOCATIONS; otherwise
+// allocationCountingEnabled() is false and the counts stay 0.
+bool allocationCountingEnabled();
+uint64_t allocationCount();
+uint64_t allocatedBytes();
+
+#endif // ALLOC_COUNTER_H
@@ -0,0 +1,242 @@
+// background_cache.cpp
+#include "background_cache.h"
+#include "cache_file.h"
+#include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'C', 'L', 'K', 'B', 'G', 'R', 'A', 'W'};
+const uint32_t CACHE_VERSION = 2;     // 2: pixel rows start PIXEL_ALIGNMENT-aligned
+const char* CACHE_EXTENSION = ".bgr";
+const size_t PIXEL_ALIGNMENT = 64;    // Keeps the mapped rows aligned for SIMD and GL uploads
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    uint32_t format;    // SDL_PixelFormatEnum
+    uint32_t pitch;     // Bytes per stored row
+    uint32_t urlLength; // URL bytes follow the header, then padding, then the pixel rows
+};
+
+size_t pixelOffsetFor(size_t urlLength) {
+    const size_t end = sizeof(CacheHeader) + urlLength;
+    return (end + PIXEL_ALIGNMENT - 1) / PIXEL_ALIGNMENT * PIXEL_ALIGNMENT;
+}
+
+// Kept in SDL_Surface::userdata of surfaces that wrap a file mapping
+struct FileMapping {
+    void* address;
+    size_t length;
+};
+
+uint64_t hashUrl(const std::string& url) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : url) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+struct CacheFile {
+    std::string path;
+    int64_t modifiedNs; // Nanoseconds: several files can be written within one second
+};
+
+std::vector<CacheFile> listCacheFiles(const std::string& directory) {
+    std::vector<CacheFile> files;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return files;
+    }
+
+    const size_t extLength = std::strlen(CACHE_EXTENSION);
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() <= extLength || name.compare(name.size() - extLength, extLength, CACHE_EXTENSION) != 0) {
+            continue;
+        }
+        std::string path = directory + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+            files.push_back({path, static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec});
+        }
+    }
+    closedir(dir);
+
+    // Newest first
+    std::sort(files.begin(), files.end(),
+              [](const CacheFile& a, const CacheFile& b) { return a.modifiedNs > b.modifiedNs; });
+    return files;
+}
+
+} // namespace
+
+BackgroundCache::BackgroundCache(const std::string& directory, size_t maxEntries)
+    : directory(directory), maxEntries(std::max<size_t>(1, maxEntries))
+{
+}
+
+std::string BackgroundCache::pathFor(const std::string& url) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hashUrl(url)));
+    return directory + "/" + name + CACHE_EXTENSION;
+}
+
+SDL_Surface* BackgroundCache::mapFile(const std::string& path, int width, int height, Uint32 format,
+                                      std::string* urlOut, const std::string* expectedUrl) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < sizeof(CacheHeader) ||
+        static_cast<uint64_t>(info.st_size) > SIZE_MAX) {
+        close(fd);
+        return nullptr;
+    }
+
+    // Private writable mapping: the pixels are only read, but SDL surfaces
+    // are not const; a stray write would copy the page, not touch the file
+    const size_t fileSize = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid
+    if (mapping == MAP_FAILED) {
+        LOG_WARNING("mmap failed for %s: %s", path.c_str(), std::strerror(errno));
+        return nullptr;
+    }
+
+    uint8_t* bytes = static_cast<uint8_t*>(mapping);
+    CacheHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+
+    // Every term is checked against fileSize on its own, in 64 bits, so a
+    // corrupt header cannot wrap a 32-bit size_t
+    const uint64_t rowBytes = static_cast<uint64_t>(width) * SDL_BYTESPERPIXEL(format);
+    const bool headerValid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                             header.version == CACHE_VERSION &&
+                             header.width == width && header.height == height && header.format == format &&
+                             header.pitch >= rowBytes && header.pitch <= INT32_MAX &&
+                             header.urlLength <= fileSize - sizeof(header);
+    const size_t pixelOffset = headerValid ? pixelOffsetFor(header.urlLength) : 0;
+    const bool valid = headerValid && height > 0 && pixelOffset <= fileSize &&
+                       static_cast<uint64_t>(header.pitch) * static_cast<uint64_t>(height) ==
+                           fileSize - pixelOffset;
+
+    SDL_Surface* surface = nullptr;
+    if (valid) {
+        std::string storedUrl(reinterpret_cast<const char*>(bytes + sizeof(header)), header.urlLength);
+        if (!expectedUrl || storedUrl == *expectedUrl) {
+            // Wrap the mapped rows: no copy, the page cache is the pixel buffer.
+            // freeSurface() unmaps once the upload is done with it.
+            surface = SDL_CreateRGBSurfaceWithFormatFrom(bytes + pixelOffset, width, height,
+                                                         SDL_BITSPERPIXEL(format), static_cast<int>(header.pitch),
+                                                         format);
+            if (surface) {
+                surface->userdata = new FileMapping{mapping, fileSize};
+                madvise(mapping, fileSize, MADV_WILLNEED); // Read ahead before the row uploads
+                if (urlOut) *urlOut = std::move(storedUrl);
+            }
+        }
+    } else {
+        LOG_DEBUG("Ignoring stale background cache file %s", path.c_str());
+    }
+
+    if (!surface) {
+        munmap(mapping, fileSize);
+        return nullptr;
+    }
+    utimensat(AT_FDCWD, path.c_str(), nullptr, 0); // Mark as recently used for eviction
+    return surface;
+}
+
+void BackgroundCache::freeSurface(SDL_Surface* surface) {
+    if (!surface) {
+        return;
+    }
+    FileMapping* mapping = (surface->flags & SDL_PREALLOC) ? static_cast<FileMapping*>(surface->userdata) : nullptr;
+    SDL_FreeSurface(surface); // Leaves preallocated pixels alone
+    if (mapping) {
+        munmap(mapping->address, mapping->length);
+        delete mapping;
+    }
+}
+
+SDL_Surface* BackgroundCache::load(const std::string& url, int width, int height, Uint32 format) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return mapFile(pathFor(url), width, height, format, nullptr, &url);
+}
+
+SDL_Surface* BackgroundCache::loadLatest(int width, int height, Uint32 format, std::string& url) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& file : listCacheFiles(directory)) {
+        SDL_Surface* surface = mapFile(file.path, width, height, format, &url, nullptr);
+        if (surface) {
+            return surface;
+        }
+    }
+    return nullptr;
+}
+
+bool BackgroundCache::store(const std::string& url, SDL_Surface* surface) {
+    if (!surface || SDL_BYTESPERPIXEL(surface->format->format) == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ensureDirectory(directory);
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.width = surface->w;
+    header.height = surface->h;
+    header.format = surface->format->format;
+    header.pitch = static_cast<uint32_t>(surface->w) * SDL_BYTESPERPIXEL(surface->format->format);
+    header.urlLength = static_cast<uint32_t>(url.size());
+
+    const std::string path = pathFor(url);
+    const bool stored = writeFileAtomically(path, [&](std::FILE* file) {
+        static const char padding[PIXEL_ALIGNMENT] = {};
+        const size_t paddingBytes = pixelOffsetFor(url.size()) - sizeof(header) - url.size();
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  std::fwrite(url.data(), 1, url.size(), file) == url.size() &&
+                  std::fwrite(padding, 1, paddingBytes, file) == paddingBytes;
+        const uint8_t* pixels = static_cast<const uint8_t*>(surface->pixels);
+        for (int y = 0; ok && y < surface->h; ++y) {
+            ok = std::fwrite(pixels + static_cast<size_t>(y) * surface->pitch, 1, header.pitch, file) == header.pitch;
+        }
+        return ok;
+    });
+    if (!stored) {
+        LOG_WARNING("Failed to store background cache %s", path.c_str());
+        return false;
+    }
+
+    LOG_DEBUG("Stored background in cache: %s", path.c_str());
+    evictOldLocked();
+    return true;
+}
+
+void BackgroundCache::evictOldLocked() {
+    auto files = listCacheFiles(directory);
+    for (size_t i = maxEntries; i < files.size(); ++i) {
+        LOG_DEBUG("Evicting background cache file %s", files[i].path.c_str());
+        std::remove(files[i].path.c_str());
+    }
+}
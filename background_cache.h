@@ -0,0 +1,47 @@
+// background_cache.h
+#ifndef BACKGROUND_CACHE_H
+#define BACKGROUND_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+// Persistent cache of decoded backgrounds, stored post-processed (scaled,
+// darkened, renderer-native format) so a restart can show the last image
+// without network or decode. One file per feed fullUrl:
+//   <directory>/<fnv1a64(url)>.bgr = header + url + padding + raw pixel rows
+// Loaded surfaces wrap an mmap of the file, so reading one costs no copy;
+// release them with freeSurface(). The newest maxEntries files (by mtime)
+// are kept. Thread-safe.
+class BackgroundCache {
+public:
+    BackgroundCache(const std::string& directory, size_t maxEntries);
+
+    // Returns a surface for url, or nullptr if it is missing or was stored
+    // for a different size or format
+    SDL_Surface* load(const std::string& url, int width, int height, Uint32 format);
+
+    // Most recently used entry matching the given size and format
+    SDL_Surface* loadLatest(int width, int height, Uint32 format, std::string& url);
+
+    // Write surface for url and evict the oldest entries over maxEntries
+    bool store(const std::string& url, SDL_Surface* surface);
+
+    // Frees a surface from load() or loadLatest(), unmapping its file. Any
+    // other surface is just SDL_FreeSurface()d, so callers can use this for
+    // every background surface they own.
+    static void freeSurface(SDL_Surface* surface);
+
+private:
+    std::string directory;
+    size_t maxEntries;
+    std::mutex mutex;
+
+    std::string pathFor(const std::string& url) const;
+    SDL_Surface* mapFile(const std::string& path, int width, int height, Uint32 format,
+                         std::string* urlOut, const std::string* expectedUrl);
+    void evictOldLocked();
+};
+
+#endif // BACKGROUND_CACHE_H
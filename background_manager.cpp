@@ -3,30 +3,44 @@
 #include "constants.h"
 #include "logger.h"
 #include "http_client.h"
+#include "io_executor.h"
+#include "image_process.h"
+#include "image_decode.h"
+#include "json_extract.h"
+#include "metrics.h"
 #include <iostream>
 #include <fstream>
 #include <ctime>
 #include <httplib.h>
 #include <SDL2/SDL_image.h>
-#include <nlohmann/json.hpp>
 #include <thread>
 #include <chrono>
 #include <algorithm>
 
-using json = nlohmann::json;
-
-BackgroundManager::BackgroundManager() 
-    : currentImage(nullptr)
-    , overlay(nullptr)
-    , pendingImage(nullptr)
-    , currentTexture(nullptr)
-    , overlayTexture(nullptr)
+BackgroundManager::BackgroundManager(IOExecutor& executor)
+    : pendingImage(nullptr)
+    , pendingCharge(MemoryPool::BACKGROUND, MemoryKind::CPU)
+    , textures{nullptr, nullptr}
+    , frontTexture(-1)
+    , uploadSurface(nullptr)
+    , uploadCharge(MemoryPool::BACKGROUND, MemoryKind::CPU)
+    , textureCharge(MemoryPool::BACKGROUND, MemoryKind::GPU)
+    , uploadRow(0)
+    , fading(false)
+    , fadeStart(0)
     , cachedRenderer(nullptr)
-    , lastUpdate(0)
     , error("")
-    , httpClient(std::make_unique<HTTPClient>(BACKGROUND_API_URL_HOST, BACKGROUND_API_URL_PORT, true))
+    , diskCache(BACKGROUND_CACHE_DIR, BACKGROUND_CACHE_ENTRIES)
+    , restoreAttempted(false)
+    , executor(executor)
+    , refreshJob(0)
+    , refreshScheduled(false)
+    , reloadJob(0)
+    , imageWidth(0)
+    , imageHeight(0)
+    , httpClient(HTTPClient::forHost(BACKGROUND_API_URL_HOST, BACKGROUND_API_URL_PORT))
 {
-    LOG_INFO("BackgroundManager initialized with shared HTTPClient instance");
+    LOG_INFO("BackgroundManager initialized with pooled HTTPClient");
 }
 
 std::string BackgroundManager::getError() const {
@@ -37,8 +51,18 @@ std::string BackgroundManager::getError() const {
 BackgroundManager::~BackgroundManager() {
     LOG_INFO("BackgroundManager destructor called");
     
-    // Signal thread to stop
-    shouldStopThread.store(true);
+    // Signal the refresh job to stop, and abort its requests: a 16 MB download's
+    // timeout applies per read, so cancel() could otherwise wait a long time
+    shouldStop.store(true);
+    std::shared_ptr<HTTPClient> activeImageClient;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        activeImageClient = imageClient;
+    }
+    httpClient->abort();
+    if (activeImageClient) {
+        activeImageClient->abort();
+    }
     
     // Wait for any texture updates to complete
     int waitCount = 0;
@@ -46,54 +70,46 @@ BackgroundManager::~BackgroundManager() {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     
-    // Join worker thread if it exists
-    if (workerThread.joinable()) {
-        LOG_DEBUG("Waiting for worker thread to finish (timeout 5s)...");
-        // We use a short timeout join simulation here since std::thread doesn't support timed_join
-        // In a real destructor we should join, but if it's stuck we might hang.
-        // Given the design, we'll just join and hope the cancellation flag works.
-        workerThread.join();
-        LOG_DEBUG("Worker thread joined successfully");
+    // Cancel the refresh job; waits if it is running (bounded by the HTTP timeouts)
+    if (refreshScheduled) {
+        LOG_DEBUG("Cancelling background refresh job");
+        executor.cancel(refreshJob);
+        refreshScheduled = false;
     }
+    executor.cancel(reloadJob); // No-op unless a reload is still queued or running
     
-    // Clean up HTTP client
-    if (httpClient) {
-        LOG_DEBUG("Cleaning up shared HTTPClient instance");
-        httpClient.reset();
-    }
+    // Release our references to the pooled HTTP clients
+    httpClient.reset();
+    imageClient.reset();
     
     // Clean up SDL resources (now safe - no thread accessing them)
     LOG_DEBUG("Cleaning up SDL resources");
-    if (currentTexture) {
-        SDL_DestroyTexture(currentTexture);
-        currentTexture = nullptr;
-    }
-    if (overlayTexture) {
-        SDL_DestroyTexture(overlayTexture);
-        overlayTexture = nullptr;
-    }
-    if (currentImage) {
-        SDL_FreeSurface(currentImage);
-        currentImage = nullptr;
-    }
-    if (overlay) {
-        SDL_FreeSurface(overlay);
-        overlay = nullptr;
-    }
+    destroyTextures();
+    freeUploadSurface();
     if (pendingImage) {
-        SDL_FreeSurface(pendingImage);
+        BackgroundCache::freeSurface(pendingImage);
         pendingImage = nullptr;
+        pendingCharge.release();
     }
     
     LOG_INFO("BackgroundManager destroyed");
 }
 
 std::string BackgroundManager::fetchImageUrl() {
-    // Use shared httpClient with mutex protection for thread safety
-    std::lock_guard<std::mutex> clientLock(httpClientMutex);
+    // HTTPClient serialises requests internally; use 5s timeout
+    auto started = std::chrono::steady_clock::now();
+    auto response = httpClient->getConditional(BACKGROUND_API_URL_PATH, 5);
+    Metrics::instance().recordRequest(RequestKind::BACKGROUND_FEED, std::chrono::steady_clock::now() - started,
+                                      response.success);
     
-    // Use 5s timeout
-    auto response = httpClient->get(BACKGROUND_API_URL_PATH, 5);
+    if (response.notModified) {
+        if (!lastFeedUrl.empty()) {
+            LOG_DEBUG("Background feed not modified");
+            return lastFeedUrl; // Skips parsing; still reloads if that image never made it to screen
+        }
+        httpClient->forgetValidators(BACKGROUND_API_URL_PATH); // Ask for the full feed next time
+        return "";
+    }
     
     if (!response.success) {
         std::lock_guard<std::mutex> lock(mutex);
@@ -109,35 +125,19 @@ std::string BackgroundManager::fetchImageUrl() {
         return "";
     }
     
-    try {
-        json data = json::parse(response.body);
-        std::string url = data[0]["fullUrl"].get<std::string>();
-        LOG_DEBUG("Fetched background image URL: %s", url.c_str());
-        return url;
-    } catch (const json::parse_error& e) {
-        std::lock_guard<std::mutex> lock(mutex);
-        error = "JSON parse error: " + std::string(e.what());
-        LOG_ERROR("%s", error.c_str());
-        return "";
-    } catch (const std::exception& e) {
+    // Only data[0].fullUrl is needed; the SAX reader stops there without building a DOM
+    std::string url;
+    std::string parseError;
+    if (!extractFirstFeedUrl(response.body, url, parseError)) {
+        httpClient->forgetValidators(BACKGROUND_API_URL_PATH);
         std::lock_guard<std::mutex> lock(mutex);
-        error = "Error processing JSON: " + std::string(e.what());
+        error = "Error processing JSON: " + parseError;
         LOG_ERROR("%s", error.c_str());
         return "";
     }
-}
-
-SDL_Surface* BackgroundManager::createDarkeningOverlay(int width, int height) {
-    SDL_Surface* overlaySurface = SDL_CreateRGBSurface(0, width, height, 32, 
-        0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
-    if (!overlaySurface) {
-        std::lock_guard<std::mutex> lock(mutex);
-        error = "SDL_CreateRGBSurface failed: " + std::string(SDL_GetError());
-        return nullptr;
-    }
-    SDL_FillRect(overlaySurface, NULL, SDL_MapRGBA(overlaySurface->format, 0, 0, 0, 
-        static_cast<int>(255 * BACKGROUND_DARKNESS)));
-    return overlaySurface;
+    LOG_DEBUG("Fetched background image URL: %s", url.c_str());
+    lastFeedUrl = url;
+    return url;
 }
 
 SDL_Surface* BackgroundManager::loadImage(const std::string& url, int width, int height) {
@@ -147,154 +147,330 @@ SDL_Surface* BackgroundManager::loadImage(const std::string& url, int width, int
     std::string host = hostWithProto.substr(hostWithProto.find("://") + 3);
     std::string path = url.substr(url.find("/", 8));
     
-    httplib::SSLClient cli(host);
-    cli.set_follow_location(true);
-    
-    // Set aggressive timeouts to prevent hangs (5s read/write, 3s connect)
-    cli.set_read_timeout(5, 0);
-    cli.set_write_timeout(5, 0);
-    cli.set_connection_timeout(3, 0);
+    // Image CDN hosts get their own pooled keep-alive client and circuit breaker.
+    // Kept in a member so the destructor can abort the download.
+    auto client = HTTPClient::forHost(host);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        imageClient = client;
+    }
+    if (shouldStop.load()) {
+        return nullptr;
+    }
     
     LOG_DEBUG("Fetching image from host: %s, path: %s", host.c_str(), path.c_str());
     
-    auto res = cli.Get(path.c_str());
-    if (!res) {
+    // Streamed into a buffer sized from Content-Length, capped so a bad feed can't exhaust RAM
+    auto started = std::chrono::steady_clock::now();
+    auto res = client->download(path, BACKGROUND_MAX_DOWNLOAD_BYTES, 5);
+    Metrics::instance().recordRequest(RequestKind::BACKGROUND_IMAGE, std::chrono::steady_clock::now() - started,
+                                      res.success && res.statusCode == 200);
+    if (res.statusCode == 0) {
         std::lock_guard<std::mutex> lock(mutex);
-        error = "Failed to get image response: " + std::string(httplib::to_string(res.error()));
-        LOG_ERROR("HTTP GET failed: %s", httplib::to_string(res.error()).c_str());
+        error = "Failed to get image response: " + res.error;
+        LOG_ERROR("HTTP GET failed: %s", res.error.c_str());
         return nullptr;
     }
     
-    if (res && res->status == 200) {
-        SDL_RWops* rw = SDL_RWFromMem((void*)res->body.data(), res->body.size());
-        if (!rw) {
-            std::lock_guard<std::mutex> lock(mutex);
-            error = "SDL_RWFromMem failed: " + std::string(SDL_GetError());
-            return nullptr;
-        }
-        
-        SDL_Surface* imageSurface = IMG_Load_RW(rw, 1);
+    if (res.statusCode == 200) {
+        // Decode at the smallest scale that still covers the screen
+        MemoryCharge bodyCharge(MemoryPool::HTTP, MemoryKind::CPU, res.body.capacity());
+        DecodedImageInfo info;
+        SDL_Surface* imageSurface = decodeImageScaled(
+            reinterpret_cast<const uint8_t*>(res.body.data()), res.body.size(), width, height, &info);
+        const size_t downloadBytes = res.body.capacity();
+        std::string().swap(res.body); // Release the compressed data before post-processing
+        bodyCharge.release();
         if (!imageSurface) {
             std::lock_guard<std::mutex> lock(mutex);
-            error = "IMG_Load_RW failed: " + std::string(IMG_GetError());
+            error = "Image decode failed: " + std::string(SDL_GetError());
             return nullptr;
         }
+        const size_t decodedBytes = static_cast<size_t>(imageSurface->pitch) * imageSurface->h;
+        MemoryCharge decodedCharge(MemoryPool::BACKGROUND, MemoryKind::CPU, decodedBytes);
         
-        SDL_Surface* scaledSurface = SDL_CreateRGBSurface(0, width, height, 32, 
-            imageSurface->format->Rmask, imageSurface->format->Gmask, 
-            imageSurface->format->Bmask, imageSurface->format->Amask);
+        // Crop-to-fill, scale into the renderer's texture format and bake in
+        // the darkening, so the main thread only copies rows to the GPU
+        SDL_Surface* scaledSurface = prepareBackgroundSurface(imageSurface, width, height,
+            textureFormat.load(), BACKGROUND_DARKNESS);
+        const int decodedWidth = imageSurface->w;
+        const int decodedHeight = imageSurface->h;
+        BackgroundCache::freeSurface(imageSurface);
         if (!scaledSurface) {
             std::lock_guard<std::mutex> lock(mutex);
-            error = "SDL_CreateRGBSurface (scaled) failed: " + std::string(SDL_GetError());
-            SDL_FreeSurface(imageSurface);
-            return nullptr;
-        }
-        
-        if (SDL_BlitScaled(imageSurface, NULL, scaledSurface, NULL) < 0) {
-            std::lock_guard<std::mutex> lock(mutex);
-            error = "SDL_BlitScaled failed: " + std::string(SDL_GetError());
-            SDL_FreeSurface(imageSurface);
-            SDL_FreeSurface(scaledSurface);
+            error = "Background post-process failed: " + std::string(SDL_GetError());
             return nullptr;
         }
         
-        SDL_FreeSurface(imageSurface);
-        
-        // Create overlay (without locking - it's thread-local)
-        SDL_Surface* newOverlay = createDarkeningOverlay(width, height);
-        if (newOverlay) {
-            std::lock_guard<std::mutex> lock(mutex);
-            if (overlay) SDL_FreeSurface(overlay);
-            overlay = newOverlay;
-        }
+        // Buffers alive together: download + decoded while decoding, decoded + output after
+        const size_t outputBytes = static_cast<size_t>(scaledSurface->pitch) * scaledSurface->h;
+        const size_t peakBytes = std::max(downloadBytes + decodedBytes, decodedBytes + outputBytes);
+        LOG_INFO("Background refresh: %dx%d source decoded at %d/8 (%dx%d) by %s; "
+                 "download %zu KB, decoded %zu KB, output %zu KB, peak %zu KB; RSS %s",
+                 info.sourceWidth, info.sourceHeight, info.scaleNum, decodedWidth, decodedHeight, info.decoder,
+                 downloadBytes / 1024, decodedBytes / 1024, outputBytes / 1024, peakBytes / 1024,
+                 Logger::instance().getFormattedMemoryUsage().c_str());
         
         return scaledSurface;
     }
     
     std::lock_guard<std::mutex> lock(mutex);
-    error = "HTTP image request failed: " + std::to_string(res ? res->status : -1);
+    error = "HTTP image request failed: " + std::to_string(res.statusCode);
     return nullptr;
 }
 
-void BackgroundManager::startBackgroundUpdate(int width, int height) {
-    std::lock_guard<std::mutex> threadLock(workerThreadMutex);
+void BackgroundManager::publishImage(SDL_Surface* image, const std::string& url) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pendingImage) {
+            BackgroundCache::freeSurface(pendingImage);
+        }
+        pendingImage = image;
+        pendingCharge.resize(surfaceBytes(image));
+        pendingImageReady = true;
+        shownUrl = url;
+    }
+    if (onImageReady) onImageReady();
+}
+
+void BackgroundManager::reloadFromCache(const std::string& url) {
+    SDL_Surface* image = diskCache.load(url, imageWidth, imageHeight, textureFormat.load());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (shouldStop.load() || shownUrl != url || pendingImage) {
+            // Shutting down, or a newer image has been published since
+            if (image) BackgroundCache::freeSurface(image);
+            return;
+        }
+        if (!image) {
+            LOG_WARNING("Background %s is not in the disk cache; the next refresh downloads it again",
+                        url.c_str());
+            shownUrl.clear();
+            return;
+        }
+        pendingImage = image;
+        pendingCharge.resize(surfaceBytes(image));
+        pendingImageReady = true;
+    }
+    LOG_INFO("Reloaded background from disk cache after renderer loss");
+    if (onImageReady) onImageReady();
+}
+
+void BackgroundManager::showImage(SDL_Surface* source, int width, int height, const std::string& name) {
+    refreshScheduled = true; // Keep update() off the network
+    imageWidth = width;
+    imageHeight = height;
+    SDL_Surface* prepared = prepareBackgroundSurface(source, width, height, textureFormat.load(), BACKGROUND_DARKNESS);
+    if (!prepared) {
+        LOG_ERROR("Background post-process failed: %s", SDL_GetError());
+        return;
+    }
+    publishImage(prepared, name);
+}
 
-    // Skip if already loading
-    if (isLoading.load()) {
-        LOG_DEBUG("Background update already in progress, skipping");
+void BackgroundManager::restoreFromCache(int width, int height) {
+    std::string url;
+    SDL_Surface* cached = diskCache.loadLatest(width, height, textureFormat.load(), url);
+    if (!cached) {
+        LOG_DEBUG("No cached background to restore");
         return;
     }
     
-    // Clean up previous thread if it exists
-    if (workerThread.joinable()) {
-        LOG_DEBUG("Joining previous worker thread");
-        workerThread.join();
+    LOG_INFO("Restored cached background (%dx%d) for %s", cached->w, cached->h, url.c_str());
+    publishImage(cached, url);
+}
+
+bool BackgroundManager::runBackgroundUpdate(int width, int height) {
+    // Show the last image from disk right away rather than the fallback color
+    if (!restoreAttempted) {
+        restoreAttempted = true;
+        restoreFromCache(width, height);
     }
     
     LOG_INFO("Starting background update");
-    isLoading.store(true);
-    shouldStopThread.store(false);
-    lastThreadStart.store(time(nullptr));
     
-    workerThread = std::thread([this, width, height]() {
-        LOG_DEBUG("Worker thread started");
-        
-        try {
-            if (shouldStopThread.load()) {
-                isLoading.store(false);
-                return;
-            }
-            
-            // Step 1: Fetch URL
-            std::string imageUrl = fetchImageUrl();
-            
-            if (shouldStopThread.load()) {
-                isLoading.store(false);
-                return;
-            }
-            
-            if (!imageUrl.empty()) {
-                // Step 2: Load Image
-                SDL_Surface* newImage = loadImage(imageUrl, width, height);
-                
-                if (shouldStopThread.load()) {
-                    if (newImage) SDL_FreeSurface(newImage);
-                    isLoading.store(false);
-                    return;
-                }
-                
-                if (newImage) {
-                    LOG_INFO("Successfully loaded background image (%dx%d)", newImage->w, newImage->h);
-                    
-                    std::lock_guard<std::mutex> lock(mutex);
-                    if (pendingImage) {
-                        SDL_FreeSurface(pendingImage);
-                    }
-                    pendingImage = newImage;
-                    pendingImageReady = true;
-                    consecutiveFailures.store(0);
-                } else {
-                    LOG_ERROR("Failed to load background image from: %s", imageUrl.c_str());
-                    // Count as failure
-                    std::lock_guard<std::mutex> lock(mutex);
-                    consecutiveFailures.fetch_add(1);
-                    lastFailedAttempt.store(time(nullptr));
-                }
-            } else {
-                LOG_ERROR("Failed to fetch image URL");
-                std::lock_guard<std::mutex> lock(mutex);
-                consecutiveFailures.fetch_add(1);
-                lastFailedAttempt.store(time(nullptr));
+    // Step 1: Fetch URL
+    std::string imageUrl = fetchImageUrl();
+    
+    if (shouldStop.load()) {
+        return true;
+    }
+    
+    if (imageUrl.empty()) {
+        LOG_ERROR("Failed to fetch image URL");
+        consecutiveFailures.fetch_add(1);
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (imageUrl == shownUrl) {
+            LOG_DEBUG("Background feed unchanged, keeping current image");
+            consecutiveFailures.store(0);
+            return true;
+        }
+    }
+    
+    // Step 2: Load Image, from the disk cache if this URL was seen before
+    SDL_Surface* newImage = diskCache.load(imageUrl, width, height, textureFormat.load());
+    if (newImage) {
+        LOG_INFO("Background loaded from disk cache, skipping download");
+    } else {
+        newImage = loadImage(imageUrl, width, height);
+        if (newImage) {
+            diskCache.store(imageUrl, newImage);
+        }
+    }
+    
+    if (shouldStop.load()) {
+        if (newImage) BackgroundCache::freeSurface(newImage);
+        return true;
+    }
+    
+    if (!newImage) {
+        LOG_ERROR("Failed to load background image from: %s (%d consecutive failures)",
+                  imageUrl.c_str(), consecutiveFailures.fetch_add(1) + 1);
+        return false;
+    }
+    
+    LOG_INFO("Successfully loaded background image (%dx%d)", newImage->w, newImage->h);
+    consecutiveFailures.store(0);
+    publishImage(newImage, imageUrl);
+    return true;
+}
+
+Uint32 BackgroundManager::chooseTextureFormat(SDL_Renderer* renderer) {
+    SDL_RendererInfo info;
+    if (renderer && SDL_GetRendererInfo(renderer, &info) == 0) {
+        // Formats are listed in the renderer's order of preference
+        for (Uint32 i = 0; i < info.num_texture_formats; ++i) {
+            Uint32 format = info.texture_formats[i];
+            if (!SDL_ISPIXELFORMAT_FOURCC(format) && SDL_BITSPERPIXEL(format) == 32) {
+                return format;
             }
-        } catch (const std::exception& e) {
-            LOG_ERROR("Exception in worker thread: %s", e.what());
-        } catch (...) {
-            LOG_ERROR("Unknown exception in worker thread");
         }
-        
-        isLoading.store(false);
-        LOG_DEBUG("Worker thread finished");
-    });
+    }
+    return SDL_PIXELFORMAT_ARGB8888;
+}
+
+void BackgroundManager::attachRenderer(SDL_Renderer* renderer) {
+    cachedRenderer = renderer;
+    textureFormat.store(chooseTextureFormat(renderer));
+    LOG_INFO("Background texture format: %s", SDL_GetPixelFormatName(textureFormat.load()));
+}
+
+bool BackgroundManager::isTransitioning() const {
+    if (uploadSurface || fading) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    return pendingImageReady;
+}
+
+void BackgroundManager::destroyTextures() {
+    for (auto& texture : textures) {
+        if (texture) {
+            SDL_DestroyTexture(texture);
+            texture = nullptr;
+        }
+    }
+    frontTexture = -1;
+    fading = false;
+    textureCharge.release();
+}
+
+void BackgroundManager::freeUploadSurface() {
+    if (uploadSurface) {
+        BackgroundCache::freeSurface(uploadSurface);
+        uploadSurface = nullptr;
+    }
+    uploadCharge.release();
+}
+
+void BackgroundManager::chargeTextures() {
+    size_t bytes = 0;
+    for (SDL_Texture* texture : textures) {
+        int w, h;
+        if (texture && SDL_QueryTexture(texture, nullptr, nullptr, &w, &h) == 0) {
+            bytes += static_cast<size_t>(w) * h * 4;
+        }
+    }
+    textureCharge.resize(bytes);
+}
+
+bool BackgroundManager::beginUpload(SDL_Renderer* renderer) {
+    if (uploadSurface->w <= 0 || uploadSurface->h <= 0) {
+        LOG_ERROR("Invalid surface dimensions: %dx%d", uploadSurface->w, uploadSurface->h);
+        return false;
+    }
+
+    // Normally converted by the worker; only a renderer change can leave a stale format
+    const Uint32 format = textureFormat.load();
+    if (uploadSurface->format->format != format) {
+        LOG_DEBUG("Converting background surface to %s on the main thread", SDL_GetPixelFormatName(format));
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(uploadSurface, format, 0);
+        if (!converted) {
+            LOG_ERROR("SDL_ConvertSurfaceFormat failed: %s", SDL_GetError());
+            return false;
+        }
+        BackgroundCache::freeSurface(uploadSurface);
+        uploadSurface = converted;
+        uploadCharge.resize(surfaceBytes(converted));
+    }
+
+    // Reuse the back texture when it already has the right shape
+    SDL_Texture*& target = textures[backTexture()];
+    if (target) {
+        Uint32 existingFormat;
+        int access, w, h;
+        if (SDL_QueryTexture(target, &existingFormat, &access, &w, &h) != 0 ||
+            existingFormat != format || w != uploadSurface->w || h != uploadSurface->h) {
+            SDL_DestroyTexture(target);
+            target = nullptr;
+        }
+    }
+    if (!target) {
+        target = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING,
+                                   uploadSurface->w, uploadSurface->h);
+        if (!target) {
+            LOG_ERROR("SDL_CreateTexture (streaming) failed: %s", SDL_GetError());
+            chargeTextures();
+            return false;
+        }
+    }
+    chargeTextures();
+    SDL_SetTextureBlendMode(target, SDL_BLENDMODE_BLEND); // For the crossfade
+
+    uploadRow = 0;
+    LOG_INFO("Uploading background image (%dx%d) over several frames",
+             uploadSurface->w, uploadSurface->h);
+    return true;
+}
+
+void BackgroundManager::continueUpload() {
+    SDL_Texture* target = textures[backTexture()];
+    const int rows = std::min(BACKGROUND_UPLOAD_ROWS_PER_FRAME, uploadSurface->h - uploadRow);
+    SDL_Rect slice = {0, uploadRow, uploadSurface->w, rows};
+    const Uint8* pixels = static_cast<const Uint8*>(uploadSurface->pixels) +
+                          static_cast<size_t>(uploadRow) * uploadSurface->pitch;
+
+    if (SDL_UpdateTexture(target, &slice, pixels, uploadSurface->pitch) != 0) {
+        LOG_ERROR("SDL_UpdateTexture failed: %s", SDL_GetError());
+        freeUploadSurface();
+        return;
+    }
+
+    uploadRow += rows;
+    if (uploadRow < uploadSurface->h) {
+        return;
+    }
+
+    // Fully uploaded: the texture holds the image now, so the CPU copy goes.
+    // After a renderer loss it is reloaded from the disk cache.
+    freeUploadSurface();
+    fading = true;
+    fadeStart = SDL_GetTicks();
+    LOG_DEBUG("Background upload finished, crossfading");
 }
 
 void BackgroundManager::updateTextures(SDL_Renderer* renderer) {
@@ -303,140 +479,74 @@ void BackgroundManager::updateTextures(SDL_Renderer* renderer) {
         return; // Another update already in progress
     }
     
-    SDL_Surface* surfaceToProcess = nullptr;
-    SDL_Surface* oldSurface = nullptr;
-    
-    // Critical section: transfer ownership of pending surface
-    {
-        std::lock_guard<std::mutex> lock(mutex);
+    // Handle renderer changes: textures belong to the old renderer
+    if (cachedRenderer != renderer) {
+        LOG_INFO("Renderer changed, recreating textures");
+        destroyTextures();
+        attachRenderer(renderer);
         
-        if (pendingImageReady && pendingImage) {
-            LOG_DEBUG("Processing pending background image");
-            
-            // Transfer ownership
-            surfaceToProcess = pendingImage;
-            oldSurface = currentImage;
-            
-            // Clear pending state
-            pendingImage = nullptr;
-            pendingImageReady = false;
-            currentImage = surfaceToProcess;  // Update current immediately
-        }
-    } // Mutex released
-    
-    // Now we own surfaceToProcess exclusively - safe to use for SDL operations
-    if (surfaceToProcess) {
-        // Validate surface before SDL operations
-        if (surfaceToProcess->w > 0 && surfaceToProcess->h > 0) {
-            LOG_INFO("Creating texture from surface (%dx%d)", 
-                     surfaceToProcess->w, surfaceToProcess->h);
-            
-            // Destroy old texture
-            if (currentTexture) {
-                SDL_DestroyTexture(currentTexture);
-                currentTexture = nullptr;
+        // Restart an unfinished upload; otherwise fetch the image on screen
+        // back from disk, unless a newer one is already waiting
+        if (uploadSurface) {
+            if (!beginUpload(renderer)) {
+                freeUploadSurface();
             }
-            
-            // Create new texture (MAIN THREAD ONLY - SAFE)
-            SDL_Texture* newTexture = SDL_CreateTextureFromSurface(renderer, surfaceToProcess);
-            if (newTexture) {
-                currentTexture = newTexture;
-                LOG_DEBUG("Texture created successfully");
-                
-                // Update overlay texture as well
-                if (overlayTexture) {
-                    SDL_DestroyTexture(overlayTexture);
-                }
-                if (overlay) {
-                    overlayTexture = SDL_CreateTextureFromSurface(renderer, overlay);
-                    if (!overlayTexture) {
-                        LOG_ERROR("Failed to create overlay texture: %s", SDL_GetError());
-                    }
-                }
-            } else {
-                LOG_ERROR("SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
+        } else if (!screenUrl.empty()) {
+            bool newerPending;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                newerPending = pendingImage != nullptr;
+            }
+            if (!newerPending) {
+                std::string url = screenUrl;
+                reloadJob = executor.post([this, url]() { reloadFromCache(url); });
             }
-        } else {
-            LOG_ERROR("Invalid surface dimensions: %dx%d", 
-                     surfaceToProcess->w, surfaceToProcess->h);
-        }
-        
-        // Free old surface if it exists
-        if (oldSurface) {
-            SDL_FreeSurface(oldSurface);
-            LOG_DEBUG("Freed old background surface");
         }
     }
     
-    // Handle renderer changes (recreate textures if needed)
-    if (cachedRenderer != renderer) {
-        LOG_INFO("Renderer changed, recreating textures");
-        cachedRenderer = renderer;
-        
-        // Destroy old textures
-        if (currentTexture) {
-            SDL_DestroyTexture(currentTexture);
-            currentTexture = nullptr;
-        }
-        if (overlayTexture) {
-            SDL_DestroyTexture(overlayTexture);
-            overlayTexture = nullptr;
-        }
-        
-        // Recreate from surfaces if available
+    // Take the next image once the previous upload and fade have finished
+    if (!uploadSurface && !fading) {
         {
             std::lock_guard<std::mutex> lock(mutex);
-            if (currentImage && currentImage->w > 0 && currentImage->h > 0) {
-                currentTexture = SDL_CreateTextureFromSurface(renderer, currentImage);
-                if (!currentTexture) {
-                    LOG_ERROR("Failed to recreate current texture: %s", SDL_GetError());
-                }
-            }
-            if (overlay && overlay->w > 0 && overlay->h > 0) {
-                overlayTexture = SDL_CreateTextureFromSurface(renderer, overlay);
-                if (!overlayTexture) {
-                    LOG_ERROR("Failed to recreate overlay texture: %s", SDL_GetError());
-                }
+            if (pendingImageReady && pendingImage) {
+                LOG_DEBUG("Processing pending background image");
+                uploadSurface = pendingImage;
+                uploadCharge.resize(pendingCharge.bytes());
+                pendingCharge.release();
+                screenUrl = shownUrl;
+                pendingImage = nullptr;
+                pendingImageReady = false;
             }
+        } // Mutex released
+        
+        if (uploadSurface && !beginUpload(renderer)) {
+            freeUploadSurface();
         }
     }
     
+    // A bounded slice per frame keeps the copy from stalling the render thread
+    if (uploadSurface) {
+        continueUpload();
+    }
+    
     // Reset the texture update flag
     textureUpdateInProgress.store(false);
 }
 
 void BackgroundManager::update(int width, int height) {
-    time_t currentTime;
-    time(&currentTime);
-    
-    // Check for hung thread
-    time_t lastStart = lastThreadStart.load();
-    if (isLoading.load() && lastStart > 0 && (currentTime - lastStart) > THREAD_TIMEOUT) {
-        LOG_WARNING("Worker thread running for %ld seconds (timeout is %d). It should finish soon due to HTTP timeouts.", 
-                  currentTime - lastStart, THREAD_TIMEOUT);
-        
-        // Do NOT detach. We must wait for it to finish to avoid use-after-free.
-        // The HTTP client timeouts (10s) should ensure it doesn't hang forever.
-        // We just skip starting a new update until this one finishes.
+    if (refreshScheduled) {
         return;
     }
     
-    // Check if we need to start a new update
-    if (!isLoading.load() && 
-        (difftime(currentTime, lastUpdate) > BACKGROUND_UPDATE_INTERVAL || currentImage == nullptr)) {
-        
-        // Backoff logic
-        const int failures = consecutiveFailures.load();
-        const time_t lastFailureTime = lastFailedAttempt.load();
-        int backoffDelay = std::min(30 * failures, 600);
-        
-        if (failures > 0 && difftime(currentTime, lastFailureTime) < backoffDelay) {
-            return;
-        }
-        
-        lastUpdate = currentTime;
-        startBackgroundUpdate(width, height);
-    }
+    imageWidth = width;
+    imageHeight = height;
+    
+    // First run is immediate; failures back off from 30 s up to 10 minutes
+    refreshJob = executor.schedulePeriodic(
+        std::chrono::seconds(BACKGROUND_UPDATE_INTERVAL),
+        {std::chrono::seconds(30), std::chrono::seconds(600)},
+        [this, width, height]() { return runBackgroundUpdate(width, height); });
+    refreshScheduled = true;
 }
 
 void BackgroundManager::draw(SDL_Renderer* renderer) {
@@ -449,19 +559,36 @@ void BackgroundManager::draw(SDL_Renderer* renderer) {
     updateTextures(renderer);
     
     // Always render something - either the image or fallback color
-    if (currentTexture) {
+    SDL_Texture* front = frontTexture >= 0 ? textures[frontTexture] : nullptr;
+    if (front) {
         // Render the background image
-        if (SDL_RenderCopy(renderer, currentTexture, NULL, NULL) != 0) {
+        if (SDL_RenderCopy(renderer, front, NULL, NULL) != 0) {
             LOG_ERROR("Failed to render background texture: %s", SDL_GetError());
         }
+    }
+    
+    if (fading) {
+        // Blend the freshly uploaded image over the old one (or the fallback color)
+        if (!front) {
+            SDL_SetRenderDrawColor(renderer, FALLBACK_BG_RED, FALLBACK_BG_GREEN, FALLBACK_BG_BLUE, 255);
+            SDL_RenderClear(renderer);
+        }
+        const int next = backTexture();
+        const Uint32 elapsed = SDL_GetTicks() - fadeStart;
+        const Uint8 alpha = elapsed >= BACKGROUND_CROSSFADE_MS
+            ? 255 : static_cast<Uint8>(elapsed * 255 / BACKGROUND_CROSSFADE_MS);
+        SDL_SetTextureAlphaMod(textures[next], alpha);
+        SDL_RenderCopy(renderer, textures[next], NULL, NULL);
         
-        // Render the darkening overlay
-        if (overlayTexture) {
-            if (SDL_RenderCopy(renderer, overlayTexture, NULL, NULL) != 0) {
-                LOG_ERROR("Failed to render overlay texture: %s", SDL_GetError());
-            }
+        if (alpha == 255) {
+            frontTexture = next; // Swap buffers
+            fading = false;
+            SDL_SetTextureBlendMode(textures[next], SDL_BLENDMODE_NONE); // Opaque from now on
         }
-    } else {
+        front = textures[next];
+    }
+    
+    if (!front) {
         // Fallback: render solid color background
         SDL_SetRenderDrawColor(renderer, FALLBACK_BG_RED, FALLBACK_BG_GREEN, FALLBACK_BG_BLUE, 255);
         SDL_RenderClear(renderer);
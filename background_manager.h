@@ -1,62 +1,110 @@
 #ifndef BACKGROUND_MANAGER_H
 #define BACKGROUND_MANAGER_H
 
+#include "background_cache.h"
+#include "memory_budget.h"
 #include <string>
 #include <SDL2/SDL.h>
 #include <mutex>
-#include <thread>
 #include <atomic>
-#include <ctime>
+#include <cstdint>
 #include <memory>
+#include <functional>
 
 class HTTPClient;
+class IOExecutor;
 
 class BackgroundManager {
 public:
-    BackgroundManager();
+    explicit BackgroundManager(IOExecutor& executor);
     ~BackgroundManager();
 
+    // Registers the periodic refresh job on the first call; cheap afterwards
     void update(int width, int height);
     void draw(SDL_Renderer* renderer);
     std::string getError() const;
 
+    // Picks the renderer's native texture format so the worker can convert
+    // images to it off the main thread. Call before the first update().
+    void attachRenderer(SDL_Renderer* renderer);
+
+    // True while a new image is being uploaded or faded in; the caller should keep drawing frames
+    bool isTransitioning() const;
+
+    // The renderer lost its textures (SDL_RENDER_DEVICE_RESET). They are rebuilt
+    // on the next draw(); the image on screen is reloaded from the disk cache.
+    void handleRenderReset() { cachedRenderer = nullptr; }
+
+    // Offline use (headless replay): show source, which is not freed, through the
+    // normal post-process, upload and fade path. No refresh job is registered.
+    void showImage(SDL_Surface* source, int width, int height, const std::string& name);
+
+    // Background updates that have failed in a row (any thread)
+    int getConsecutiveFailures() const { return consecutiveFailures.load(); }
+
+    // Called from an executor thread when a new image is ready to upload. Set before the first update().
+    void setImageReadyCallback(std::function<void()> callback) { onImageReady = std::move(callback); }
+
 private:
-    SDL_Surface* currentImage;
-    SDL_Surface* overlay;
+    // Only images not yet on the GPU are kept on the CPU: once uploaded, the
+    // surface is freed and reloaded from diskCache if the textures are lost
     SDL_Surface* pendingImage;
+    MemoryCharge pendingCharge;    // Guarded by mutex, like pendingImage
     
     // Surface ownership tracking
     bool pendingImageReady{false};  // Flag that pendingImage is ready to process
     std::atomic<bool> textureUpdateInProgress{false};
     
-    // Cache the textures instead of recreating every frame
-    SDL_Texture* currentTexture;
-    SDL_Texture* overlayTexture;
+    // Double-buffered streaming textures: the front one is shown while the
+    // next image is uploaded into the other a few rows per frame, then faded in
+    SDL_Texture* textures[2];
+    int frontTexture;              // -1 until the first image has been shown
+    SDL_Surface* uploadSurface;    // Image being uploaded (main thread only)
+    MemoryCharge uploadCharge;
+    MemoryCharge textureCharge;
+    std::string screenUrl;         // Image being uploaded or on screen (main thread only)
+    int uploadRow;
+    bool fading;
+    Uint32 fadeStart;
+    std::atomic<Uint32> textureFormat{SDL_PIXELFORMAT_ARGB8888};
     SDL_Renderer* cachedRenderer;
     
-    time_t lastUpdate;
-    std::atomic<time_t> lastFailedAttempt{0};
     std::atomic<int> consecutiveFailures{0};
     std::string error;
-    std::atomic<bool> isLoading{false};
+    std::string shownUrl;          // Feed URL of the newest image handed to the main thread
+    std::string lastFeedUrl;       // From the last full feed response (executor thread only)
     mutable std::mutex mutex;
-    mutable std::mutex httpClientMutex;  // Separate mutex for HTTP client access
     
-    // Simplified threading: Single worker thread
-    std::thread workerThread;
-    std::unique_ptr<HTTPClient> httpClient;
+    // Decoded images survive restarts; the first refresh run restores the newest one
+    BackgroundCache diskCache;
+    bool restoreAttempted;         // Executor thread only
     
-    // Thread management
-    std::mutex workerThreadMutex; // Protects workerThread lifecycle
-    std::atomic<bool> shouldStopThread{false};
-    std::atomic<time_t> lastThreadStart{0};
-    static constexpr int THREAD_TIMEOUT = 60; // seconds
+    // Refreshes run as a periodic job on the shared I/O executor
+    IOExecutor& executor;
+    uint64_t refreshJob;
+    bool refreshScheduled;  // Main thread only
+    uint64_t reloadJob;     // Last reload after a renderer loss (main thread only)
+    int imageWidth;         // Size every image is prepared at
+    int imageHeight;
+    std::shared_ptr<HTTPClient> httpClient;  // Pooled client for the image API host
+    std::shared_ptr<HTTPClient> imageClient; // Client of the last image download's CDN host (guarded by mutex)
+    std::atomic<bool> shouldStop{false};
+    std::function<void()> onImageReady;
 
     std::string fetchImageUrl();
     SDL_Surface* loadImage(const std::string& url, int width, int height);
-    SDL_Surface* createDarkeningOverlay(int width, int height);
-    void startBackgroundUpdate(int width, int height);
+    bool runBackgroundUpdate(int width, int height);  // Job body; false triggers a backoff retry
+    void restoreFromCache(int width, int height);
+    void publishImage(SDL_Surface* image, const std::string& url);
+    void reloadFromCache(const std::string& url);  // Job body after a renderer loss
     void updateTextures(SDL_Renderer* renderer);
+    bool beginUpload(SDL_Renderer* renderer);
+    void continueUpload();
+    void destroyTextures();
+    void freeUploadSurface();
+    void chargeTextures();
+    int backTexture() const { return frontTexture < 0 ? 0 : 1 - frontTexture; }
+    static Uint32 chooseTextureFormat(SDL_Renderer* renderer);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+// bench.h
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Minimal in-tree benchmark harness, so the same binary runs on x86 and ARM
+// without extra dependencies. A benchmark does its setup, then loops:
+//
+//   BENCHMARK(snow_update_666) {
+//       SnowSystem snow(...);          // Not timed
+//       while (state.next()) {         // Timed
+//           snow.update(1.0f / 60.0f);
+//       }
+//   }
+class BenchState {
+public:
+    explicit BenchState(uint64_t iterations) : remaining(iterations), iterations(iterations), started(false) {}
+
+    bool next() {
+        if (!started) {
+            started = true;
+            start = std::chrono::steady_clock::now();
+        }
+        if (remaining == 0) {
+            stop = std::chrono::steady_clock::now();
+            return false;
+        }
+        --remaining;
+        return true;
+    }
+
+    // Work items per iteration (e.g. flakes), for an items/s column
+    void setItemsPerIteration(uint64_t items) { itemsPerIteration = items; }
+
+    uint64_t getIterations() const { return iterations; }
+    uint64_t getItemsPerIteration() const { return itemsPerIteration; }
+    double elapsedSeconds() const { return std::chrono::duration<double>(stop - start).count(); }
+
+private:
+    uint64_t remaining;
+    uint64_t iterations;
+    uint64_t itemsPerIteration = 0;
+    bool started;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point stop;
+};
+
+using BenchFunction = void (*)(BenchState&);
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFunction function);
+};
+
+#define BENCHMARK(name) \
+    static void bench_##name(BenchState& state); \
+    static BenchRegistrar registrar_##name(#name, bench_##name); \
+    static void bench_##name(BenchState& state)
+
+// Keeps the compiler from discarding a result
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Shared 1024x600 ARGB8888 software renderer (created on first use)
+SDL_Renderer* benchRenderer();
+
+// Contents of bench/fixtures/<name>
+std::string benchFixture(const char* name);
+
+#endif // BENCH_H
@@ -0,0 +1,74 @@
+// bench_display.cpp
+#include "bench.h"
+#include "config.h"
+#include "display.h"
+#include <string>
+#include <vector>
+
+// Reaches Display's private text paths (declared a friend in display.h)
+class DisplayBench {
+public:
+    static SDL_Texture* texture(Display& display, const std::string& text, FontSize size) {
+        return display.getOrCreateTexture(text, size, WHITE_COLOR, true);
+    }
+
+    static std::vector<std::string> wrap(Display& display, const std::string& text, FontSize size, int maxWidth) {
+        return display.wrapText(text, display.getFont(size), maxWidth);
+    }
+};
+
+namespace {
+
+// Fonts and atlases take a while to build, so one Display serves every run.
+// Deliberately leaked: the process exits right after the benchmarks.
+Display& benchDisplay() {
+    static Display* display = new Display(benchRenderer(), 1024, 600);
+    return *display;
+}
+
+// Advice as returned by the model, one to three lines on screen
+const char* const ADVICE_TEXTS[] = {
+    "Наденьте тёплую куртку, шапку и перчатки: на улице мороз и сильный ветер.",
+    "Сегодня прохладно и возможен дождь, поэтому возьмите зонт и наденьте непромокаемую обувь. "
+    "Лёгкий свитер под куртку не помешает.",
+    "Очень холодно! Одевайтесь многослойно: термобельё, флисовая кофта, пуховик, тёплые ботинки, "
+    "шарф и варежки. Старайтесь не задерживаться на улице надолго и берегите открытые участки кожи от обморожения.",
+};
+
+} // namespace
+
+BENCHMARK(display_texture_hit) {
+    Display& display = benchDisplay();
+    display.setCacheBudget(TEXT_CACHE_MAX_BYTES);
+    const std::string text = "14:35";
+    DisplayBench::texture(display, text, FontSize::SMALL); // Warm
+    while (state.next()) {
+        benchKeep(DisplayBench::texture(display, text, FontSize::SMALL));
+    }
+}
+
+BENCHMARK(display_texture_miss) {
+    Display& display = benchDisplay();
+    std::vector<std::string> texts;
+    for (int i = 0; i < 1024; ++i) {
+        texts.push_back(std::to_string(i) + "°C");
+    }
+    // A budget of a few textures makes every lookup in the cycle a miss (rasterize + evict)
+    display.setCacheBudget(64 * 1024);
+    size_t i = 0;
+    while (state.next()) {
+        benchKeep(DisplayBench::texture(display, texts[i++ % texts.size()], FontSize::SMALL));
+    }
+    display.clearCache();
+    display.setCacheBudget(TEXT_CACHE_MAX_BYTES);
+}
+
+BENCHMARK(display_wrap_text) {
+    Display& display = benchDisplay();
+    const int maxWidth = 1024 * 9 / 10;
+    size_t i = 0;
+    while (state.next()) {
+        const std::string text = ADVICE_TEXTS[i++ % 3];
+        benchKeep(DisplayBench::wrap(display, text, FontSize::EXTRA_SMALL, maxWidth));
+    }
+}
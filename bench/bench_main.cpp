@@ -0,0 +1,182 @@
+// bench_main.cpp
+#include "bench.h"
+#include "constants.h"
+#include "image_process.h"
+#include "snow_kernel.h"
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+namespace {
+
+struct Registered {
+    const char* name;
+    BenchFunction function;
+};
+
+std::vector<Registered>& registry() {
+    static std::vector<Registered> benchmarks;
+    return benchmarks;
+}
+
+SDL_Surface* rendererSurface = nullptr;
+SDL_Renderer* renderer = nullptr;
+
+const double CALIBRATION_SECONDS = 0.05;
+const int REPETITIONS = 5;
+
+double runOnce(BenchFunction function, uint64_t iterations, uint64_t& items) {
+    BenchState state(iterations);
+    function(state);
+    items = state.getItemsPerIteration();
+    return state.elapsedSeconds();
+}
+
+// The build copies assets/ and bench/fixtures/ next to the binary
+std::string executableDirectory(const char* argv0) {
+    char path[PATH_MAX];
+    const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    std::string exe = length > 0 ? std::string(path, static_cast<size_t>(length)) : std::string(argv0);
+    const size_t slash = exe.rfind('/');
+    return slash == std::string::npos ? "." : exe.substr(0, slash);
+}
+
+// Caches written while benchmarking go to a scratch directory, never into
+// the data directory or a deployed clock's cache
+std::string cacheDirectory;
+std::string fontMetricsCachePath;
+
+bool redirectCaches() {
+    char pattern[] = "/tmp/clock_bench.XXXXXX";
+    if (!mkdtemp(pattern)) {
+        return false;
+    }
+    cacheDirectory = pattern;
+    fontMetricsCachePath = cacheDirectory + "/font_metrics.json";
+    FONT_METRICS_CACHE_PATH = fontMetricsCachePath.c_str();
+    return true;
+}
+
+void removeCaches() {
+    if (!cacheDirectory.empty()) {
+        std::remove(fontMetricsCachePath.c_str());
+        rmdir(cacheDirectory.c_str());
+    }
+}
+
+} // namespace
+
+BenchRegistrar::BenchRegistrar(const char* name, BenchFunction function) {
+    registry().push_back({name, function});
+}
+
+SDL_Renderer* benchRenderer() {
+    if (!renderer) {
+        rendererSurface = SDL_CreateRGBSurfaceWithFormat(0, 1024, 600, 32, SDL_PIXELFORMAT_ARGB8888);
+        renderer = rendererSurface ? SDL_CreateSoftwareRenderer(rendererSurface) : nullptr;
+        if (!renderer) {
+            std::fprintf(stderr, "Software renderer failed: %s\n", SDL_GetError());
+            std::exit(1);
+        }
+    }
+    return renderer;
+}
+
+std::string benchFixture(const char* name) {
+    std::ifstream file(std::string("bench/fixtures/") + name, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "Missing fixture bench/fixtures/%s\n", name);
+        std::exit(1);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+int main(int argc, char** argv) {
+    // Usage: clock_bench [--data-dir DIR] [filter] [seconds per benchmark]
+    std::string dataDir = executableDirectory(argv[0]);
+    std::vector<const char*> positional;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc) {
+            dataDir = argv[++i];
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    const char* filter = positional.size() > 0 ? positional[0] : "";
+    const double targetSeconds = positional.size() > 1 ? std::max(0.01, std::atof(positional[1])) : 0.2;
+
+    // Fonts and fixtures are looked up relative to the data directory, which
+    // has the source tree's layout (assets/, bench/fixtures/)
+    if (chdir(dataDir.c_str()) != 0) {
+        std::fprintf(stderr, "Cannot chdir to data directory %s\n", dataDir.c_str());
+        return 1;
+    }
+    if (!redirectCaches()) {
+        std::fprintf(stderr, "Cannot create a cache directory: %s\n", std::strerror(errno));
+        return 1;
+    }
+    if (SDL_Init(0) != 0 || TTF_Init() != 0) {
+        std::fprintf(stderr, "SDL init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    utsname host;
+    uname(&host);
+    std::printf("clock_bench on %s %s, snow kernel %s, image kernel %s\n",
+                host.sysname, host.machine, snowKernelName(), imageKernelName());
+    std::printf("%-34s %12s %14s %14s %14s\n", "benchmark", "iterations", "median ns/op", "min ns/op", "items/s");
+
+    auto& benchmarks = registry();
+    std::sort(benchmarks.begin(), benchmarks.end(),
+              [](const Registered& a, const Registered& b) { return std::strcmp(a.name, b.name) < 0; });
+
+    for (const auto& bench : benchmarks) {
+        if (std::strstr(bench.name, filter) == nullptr) {
+            continue;
+        }
+
+        // Grow the iteration count until a run is long enough to time, then size it to the target
+        uint64_t items = 0;
+        uint64_t iterations = 1;
+        double elapsed = runOnce(bench.function, iterations, items);
+        while (elapsed < CALIBRATION_SECONDS && iterations < (1ULL << 40)) {
+            iterations *= 2;
+            elapsed = runOnce(bench.function, iterations, items);
+        }
+        iterations = std::max<uint64_t>(1, static_cast<uint64_t>(iterations * targetSeconds / std::max(elapsed, 1e-9)));
+
+        std::vector<double> perOp;
+        for (int r = 0; r < REPETITIONS; ++r) {
+            perOp.push_back(runOnce(bench.function, iterations, items) * 1e9 / iterations);
+        }
+        std::sort(perOp.begin(), perOp.end());
+        const double median = perOp[perOp.size() / 2];
+
+        char itemsRate[32] = "-";
+        if (items > 0) {
+            std::snprintf(itemsRate, sizeof(itemsRate), "%.3g", items * 1e9 / median);
+        }
+        std::printf("%-34s %12llu %14.1f %14.1f %14s\n", bench.name,
+                    static_cast<unsigned long long>(iterations), median, perOp.front(), itemsRate);
+        std::fflush(stdout);
+    }
+
+    if (renderer) SDL_DestroyRenderer(renderer);
+    if (rendererSurface) SDL_FreeSurface(rendererSurface);
+    TTF_Quit();
+    SDL_Quit();
+    removeCaches();
+    return 0;
+}
@@ -0,0 +1,51 @@
+// bench_parsing.cpp
+#include "bench.h"
+#include "json_extract.h"
+#include "weather.h"
+#include <nlohmann/json.hpp>
+
+BENCHMARK(weather_description_cached) {
+    while (state.next()) {
+        benchKeep(getWeatherDescription(-4.2, 73, 13.7));
+    }
+}
+
+BENCHMARK(weather_description_varied) {
+    // 256 distinct (temperature, code, wind) keys, about what a season of
+    // five-minute updates produces and well under the intern table cap
+    const int codes[] = {0, 1, 2, 3, 45, 61, 63, 71, 73, 75, 95};
+    const int KEYS = 256;
+    int i = 0;
+    while (state.next()) {
+        const int k = i % KEYS;
+        benchKeep(getWeatherDescription(-10.0 + k % 32, codes[k % 11], (k / 32) * 1.5));
+        ++i;
+    }
+}
+
+BENCHMARK(json_weather_sax) {
+    const std::string body = benchFixture("weather.json");
+    WeatherData data;
+    std::string error;
+    while (state.next()) {
+        benchKeep(extractWeather(body, data, error));
+    }
+}
+
+// What extractWeather() replaced, for comparison
+BENCHMARK(json_weather_dom) {
+    const std::string body = benchFixture("weather.json");
+    while (state.next()) {
+        nlohmann::json data = nlohmann::json::parse(body);
+        benchKeep(data["current_weather"]["temperature"].get<double>());
+    }
+}
+
+BENCHMARK(json_feed_sax) {
+    const std::string body = benchFixture("feed.json");
+    std::string url;
+    std::string error;
+    while (state.next()) {
+        benchKeep(extractFirstFeedUrl(body, url, error));
+    }
+}
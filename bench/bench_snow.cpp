@@ -0,0 +1,34 @@
+// bench_snow.cpp
+#include "bench.h"
+#include "snow_system.h"
+
+namespace {
+
+void benchUpdate(BenchState& state, int flakes, int threads = 0) {
+    SnowSystem snow(flakes, 1024, 600, threads);
+    snow.initialize(benchRenderer());
+    state.setItemsPerIteration(flakes);
+    while (state.next()) {
+        snow.update(1.0f / 60.0f);
+    }
+}
+
+void benchDraw(BenchState& state, int flakes) {
+    SDL_Renderer* renderer = benchRenderer();
+    SnowSystem snow(flakes, 1024, 600);
+    snow.initialize(renderer);
+    state.setItemsPerIteration(flakes);
+    while (state.next()) {
+        snow.draw(renderer);
+    }
+}
+
+} // namespace
+
+BENCHMARK(snow_update_666) { benchUpdate(state, 666); }
+BENCHMARK(snow_update_5k) { benchUpdate(state, 5000); }
+BENCHMARK(snow_update_20k) { benchUpdate(state, 20000); }
+BENCHMARK(snow_update_20k_3threads) { benchUpdate(state, 20000, 3); }
+
+BENCHMARK(snow_draw_666) { benchDraw(state, 666); }
+BENCHMARK(snow_draw_5k) { benchDraw(state, 5000); }
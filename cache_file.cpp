@@ -0,0 +1,49 @@
+// cache_file.cpp
+#include "cache_file.h"
+#include "logger.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+
+bool ensureDirectory(const std::string& directory) {
+    for (size_t pos = directory.find('/'); ; pos = directory.find('/', pos + 1)) {
+        std::string part = directory.substr(0, pos);
+        if (!part.empty() && mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) {
+            LOG_WARNING("Failed to create cache directory %s: %s", part.c_str(), std::strerror(errno));
+            return false;
+        }
+        if (pos == std::string::npos) return true;
+    }
+}
+
+bool ensureParentDirectory(const std::string& filePath) {
+    size_t slash = filePath.find_last_of('/');
+    if (slash == std::string::npos || slash == 0) return true;
+    return ensureDirectory(filePath.substr(0, slash));
+}
+
+bool writeFileAtomically(const std::string& path, const std::function<bool(std::FILE*)>& write) {
+    ensureParentDirectory(path);
+
+    const std::string tempPath = path + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        LOG_WARNING("Failed to write %s: %s", tempPath.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    bool ok = write(file);
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        LOG_WARNING("Failed to replace %s: %s", path.c_str(), std::strerror(errno));
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool writeFileAtomically(const std::string& path, const std::string& contents) {
+    return writeFileAtomically(path, [&contents](std::FILE* file) {
+        return std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    });
+}
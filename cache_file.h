@@ -0,0 +1,23 @@
+// cache_file.h
+#ifndef CACHE_FILE_H
+#define CACHE_FILE_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+// File helpers shared by the on-disk caches (font metrics, backgrounds, advice)
+
+// mkdir -p; false (with a warning logged) if a component cannot be created
+bool ensureDirectory(const std::string& directory);
+
+// ensureDirectory() for the directory part of filePath
+bool ensureParentDirectory(const std::string& filePath);
+
+// Writes path through path + ".tmp" and rename(), so a crash never leaves a
+// torn file. write() fills the open temp file and returns false on a short
+// write; the temp file is removed on any failure.
+bool writeFileAtomically(const std::string& path, const std::function<bool(std::FILE*)>& write);
+bool writeFileAtomically(const std::string& path, const std::string& contents);
+
+#endif // CACHE_FILE_H
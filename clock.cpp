@@ -7,36 +7,135 @@
 #include "background_manager.h"
 #include "config.h"
 #include "weather.h"
-#include "clothing_advice.h"
+#include "advice_service.h"
+#include "frame_scheduler.h"
+#include "http_client.h"
+#include "io_executor.h"
+#include "frame_profiler.h"
+#include "metrics.h"
+#include "alloc_counter.h"
+#include "snow_kernel.h"
+#include "render_layer.h"
+#include "quality_governor.h"
+#include "memory_budget.h"
+#include "render_backend.h"
 #include "logger.h"
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <cmath>
 #include <ctime>
 #include <chrono>
-#include <iomanip>
 #include <sstream>
+#include <thread>
+
+Clock::Clock(const ClockOptions& options)
+    : options(options),
+      screenWidth(options.width > 0 ? options.width : SCREEN_WIDTH),
+      screenHeight(options.height > 0 ? options.height : SCREEN_HEIGHT),
+      running(false), window(nullptr), renderer(nullptr), display(nullptr), snow(nullptr),
+      weatherAPI(nullptr), backgroundManager(nullptr), adviceService(nullptr), scheduler(nullptr),
+      ioExecutor(nullptr), profiler(nullptr), metricsServer(nullptr), textLayer(nullptr),
+      adviceLayer(nullptr), adviceLayerTop(0),
+      snowGovernor(nullptr),
+      lastAdviceUpdate(0), adviceUpdateInterval(15 * 60), forecastVersion(0),
+      startTime(std::chrono::steady_clock::now()), firstFrameDrawn(false), replayClock(0.0) {
+}
+
+namespace {
+
+// Logs the duration of each startup phase so time-to-first-frame can be tracked across the fleet
+class StartupTimer {
+public:
+    StartupTimer() : last(std::chrono::steady_clock::now()) {}
+
+    void phase(const char* name) {
+        auto now = std::chrono::steady_clock::now();
+        LOG_INFO("Startup phase '%s' took %lld ms", name,
+                 static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - last).count()));
+        last = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point last;
+};
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
 
-Clock::Clock() : running(false), window(nullptr), renderer(nullptr), display(nullptr), snow(nullptr),
-                 weatherAPI(nullptr), backgroundManager(nullptr), lastAdviceUpdate(0), adviceUpdateInterval(15 * 60) {
+// Deterministic stand-in for a feed photo: smooth gradients with some detail
+SDL_Surface* makeReplayBackground(int width, int height) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 24, SDL_PIXELFORMAT_RGB24);
+    if (!surface) {
+        return nullptr;
+    }
+    for (int y = 0; y < height; ++y) {
+        Uint8* row = static_cast<Uint8*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch;
+        for (int x = 0; x < width; ++x) {
+            row[x * 3 + 0] = static_cast<Uint8>(40 + 120 * y / height);
+            row[x * 3 + 1] = static_cast<Uint8>(60 + 100 * x / width);
+            row[x * 3 + 2] = static_cast<Uint8>(150 + ((x ^ y) & 63));
+        }
+    }
+    return surface;
 }
 
+} // namespace
+
 Clock::~Clock() {
     running = false; // Stop the main loop first
 
+    // The metrics server reads the profiler and background manager
+    if (metricsServer) {
+        metricsServer->stop();
+        delete metricsServer;
+        metricsServer = nullptr;
+    }
+
+    if (snowGovernor) {
+        delete snowGovernor;
+        snowGovernor = nullptr;
+    }
+
     // Delete the snow system first since it depends on the renderer
     if (snow) {
         delete snow;
         snow = nullptr;
     }
 
-    // Delete the display next as it also uses renderer
+    // Delete the display and the text layers next as they also use renderer
+    if (textLayer) {
+        delete textLayer;
+        textLayer = nullptr;
+    }
+    if (adviceLayer) {
+        delete adviceLayer;
+        adviceLayer = nullptr;
+    }
     if (display) {
         delete display;
         display = nullptr;
     }
 
+    // Stop the advice worker before anything it might still be reporting to
+    if (adviceService) {
+        adviceService->stop();
+        delete adviceService;
+        adviceService = nullptr;
+    }
+
     // Stop and delete weather API
     if (weatherAPI) {
         weatherAPI->stop();
@@ -50,6 +149,21 @@ Clock::~Clock() {
         backgroundManager = nullptr;
     }
 
+    if (scheduler) {
+        delete scheduler;
+        scheduler = nullptr;
+    }
+
+    delete profiler;
+    profiler = nullptr;
+
+    // All jobs have been cancelled by their owners above
+    if (ioExecutor) {
+        ioExecutor->stop();
+        delete ioExecutor;
+        ioExecutor = nullptr;
+    }
+
     // Finally, clean up SDL resources
     if (renderer) {
         SDL_DestroyRenderer(renderer);
@@ -67,8 +181,26 @@ Clock::~Clock() {
 }
 
 bool Clock::initialize() {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        LOG_CRITICAL("SDL_Init Error: %s", SDL_GetError());
+    StartupTimer timer;
+    MemoryBudget::instance().setLimit(MEMORY_BUDGET_BYTES);
+
+    // Network fetches go first so they overlap with SDL, font and snow setup
+    ioExecutor = new IOExecutor(IO_EXECUTOR_THREADS);
+    ioExecutor->start();
+    weatherAPI = new WeatherAPI(*ioExecutor);
+    weatherAPI->setUpdateCallback(&FrameScheduler::requestWake);
+    if (!options.headless) {
+        weatherAPI->start(); // Start background weather updates
+    }
+    timer.phase("weather start");
+
+    RenderBackend backend = options.backend;
+    if (options.headless) {
+        setenv("SDL_VIDEODRIVER", "dummy", 1); // No display needed; we render in software
+        backend = RenderBackend::SDL_DEFAULT;
+    }
+
+    if (!initVideoBackend(backend)) {
         return false;
     }
 
@@ -88,8 +220,8 @@ bool Clock::initialize() {
         return false;
     }
 
-    window = SDL_CreateWindow("Digital Clock C++", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH,
-                              SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+    window = SDL_CreateWindow("Digital Clock C++", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, screenWidth,
+                              screenHeight, SDL_WINDOW_SHOWN | backendWindowFlags(backend));
     if (!window) {
         LOG_CRITICAL("SDL_CreateWindow Error: %s", SDL_GetError());
         TTF_Quit();
@@ -98,7 +230,9 @@ bool Clock::initialize() {
         return false;
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    renderer = SDL_CreateRenderer(window, -1, options.headless
+                                  ? SDL_RENDERER_SOFTWARE | SDL_RENDERER_TARGETTEXTURE
+                                  : SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (!renderer) {
         LOG_CRITICAL("SDL_CreateRenderer Error: %s", SDL_GetError());
         SDL_DestroyWindow(window);
@@ -107,50 +241,330 @@ bool Clock::initialize() {
         SDL_Quit();
         return false;
     }
+    logRenderBackend(renderer, backend);
 
-    display = new Display(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
-    display->setFpsVisible(false); // Hide FPS counter
+    timer.phase("SDL window and renderer");
+
+    scheduler = new FrameScheduler(FRAME_MODE, FRAME_RATE_CAP);
+    SDL_DisplayMode displayMode;
+    const int refreshRate = (SDL_GetWindowDisplayMode(window, &displayMode) == 0 && displayMode.refresh_rate > 0)
+                                ? displayMode.refresh_rate : 60;
+    if (FRAME_PROFILING_ENABLED || METRICS_ENABLED || options.headless) {
+        profiler = new FrameProfiler(refreshRate);
+        LOG_INFO("Frame profiling enabled (%d Hz vsync)", refreshRate);
+    }
 
-    snow = new SnowSystem(NUM_SNOWFLAKES, SCREEN_WIDTH, SCREEN_HEIGHT);
+    // Workers wake the main loop when their data changes (matters in IDLE mode).
+    // Kick off the first background fetch now rather than on the first frame.
+    backgroundManager = new BackgroundManager(*ioExecutor);
+    backgroundManager->setImageReadyCallback(&FrameScheduler::requestWake);
+    backgroundManager->attachRenderer(renderer);
+    if (!options.headless) {
+        backgroundManager->update(screenWidth, screenHeight);
+        adviceService = new AdviceService(*ioExecutor, CLOTHING_ADVICE_LANGUAGE);
+        adviceService->setResultCallback(&FrameScheduler::requestWake);
+        adviceService->start(); // Advice is fetched off the render thread
+        // Last run's advice is on screen until the weather arrives
+        adviceService->getCachedAdvice(clothingAdvice);
+    } else if (!initializeReplayData()) {
+        return false;
+    }
+    timer.phase("background and advice start");
+
+    display = new Display(renderer, screenWidth, screenHeight);
+    display->setFpsVisible(false); // Hide FPS counter
+    if (LAYER_COMPOSITING_ENABLED) {
+        createTextLayers();
+    }
+    timer.phase("fonts and glyph atlases");
+
+    const bool governed = SNOW_GOVERNOR_ENABLED && !options.headless;
+    const int simulationThreads = std::thread::hardware_concurrency() > 1 ? SNOW_SIMULATION_THREADS : 0;
+    snow = new SnowSystem(governed ? SNOW_MAX_FLAKES : NUM_SNOWFLAKES, screenWidth, screenHeight,
+                          simulationThreads);
+    if (options.headless) {
+        snow->seed(options.seed);
+    }
+    if (governed) {
+        snowGovernor = new QualityGovernor(refreshRate, SNOW_MIN_FLAKES, SNOW_MAX_FLAKES, NUM_SNOWFLAKES);
+        snow->setQuality(snowGovernor->quality());
+    }
     snow->initialize(renderer); // Initialize the snow system with a renderer
-    weatherAPI = new WeatherAPI();
-    weatherAPI->start(); // Start background weather updates
-    backgroundManager = new BackgroundManager();
+    timer.phase("snow");
+
+    if (METRICS_ENABLED && !options.headless) {
+        metricsServer = new MetricsServer(METRICS_PORT, profiler, backgroundManager);
+        if (!metricsServer->start()) {
+            delete metricsServer; // Keep running without metrics
+            metricsServer = nullptr;
+        }
+    }
 
     running = true;
     return true;
 }
 
-void Clock::run() {
+int Clock::run() {
     if (!initialize()) {
-        return;
+        return 1;
+    }
+    if (options.headless) {
+        return runHeadless();
     }
 
     auto lastHeartbeat = std::chrono::steady_clock::now();
     
     while (running) {
-        handleEvents();
-        update();
-        draw();
+        scheduler->waitForNextFrame();
+        {
+            ScopedPhase phase(profiler, FramePhase::EVENTS);
+            handleEvents();
+        }
+
+        if (scheduler->isFrameDue()) {
+            float dt = scheduler->beginFrame();
+            if (snowGovernor && scheduler->getMode() == FrameMode::FULL_RATE &&
+                snowGovernor->recordFrame(dt)) {
+                snow->setQuality(snowGovernor->quality());
+            }
+            if (profiler) {
+                profiler->beginFrame(scheduler->getMode() == FrameMode::FULL_RATE);
+            }
+            ScopedPhase phase(profiler, FramePhase::FRAME);
+            update(scheduler->isAnimating() ? dt : 0.0f);
+            draw();
+            if (metricsServer) {
+                Metrics::instance().publishTextCache(display->getCacheStats()); // Relaxed stores only
+            }
+
+            if (!firstFrameDrawn) {
+                firstFrameDrawn = true;
+                LOG_INFO("Time to first frame: %lld ms", static_cast<long long>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startTime).count()));
+            }
+        }
         
         // Watchdog heartbeat
         auto now = std::chrono::steady_clock::now();
         if (std::chrono::duration_cast<std::chrono::seconds>(now - lastHeartbeat).count() >= 60) {
             LOG_INFO("Heartbeat - Main loop running. RSS: %s", Logger::instance().getFormattedMemoryUsage().c_str());
+            TextCacheStats cache = display->getCacheStats();
+            LOG_INFO("Text cache: %zu entries, %zu/%zu KB, hits %llu, misses %llu, evictions %llu, expired %llu",
+                     cache.entries, cache.residentBytes / 1024, cache.budgetBytes / 1024,
+                     static_cast<unsigned long long>(cache.hits),
+                     static_cast<unsigned long long>(cache.misses),
+                     static_cast<unsigned long long>(cache.evictions),
+                     static_cast<unsigned long long>(cache.expirations));
+            LOG_INFO("Layout cache: %zu layouts, %zu KB", cache.layouts, cache.layoutBytes / 1024);
+            if (profiler && FRAME_PROFILING_ENABLED) {
+                profiler->logReport();
+            }
+            if (snowGovernor) {
+                snowGovernor->logStatus();
+            }
+            MemoryBudget::instance().logStatus();
+            HTTPClient::reapIdleConnections(); // Close keep-alive sockets nobody used recently
             lastHeartbeat = now;
         }
     }
+    return 0;
+}
+
+bool Clock::initializeReplayData() {
+    // Recorded weather response (same fixture clock_bench uses)
+    std::string body;
+    if (!readFile(options.fixtureDir + "/weather.json", body) || !weatherAPI->loadResponse(body)) {
+        LOG_CRITICAL("Headless: cannot load %s/weather.json", options.fixtureDir.c_str());
+        return false;
+    }
+
+    // Advice text; the service is not created so nothing reaches the network
+    std::string advice;
+    if (readFile(options.fixtureDir + "/advice.txt", advice)) {
+        while (!advice.empty() && (advice.back() == '\n' || advice.back() == '\r')) {
+            advice.pop_back();
+        }
+        clothingAdvice = advice;
+    } else {
+        LOG_WARNING("Headless: no %s/advice.txt, drawing without advice", options.fixtureDir.c_str());
+    }
+    // Start the simulated clock on a minute boundary: the text changes only
+    // after 60 s of simulated time, the same frame on every run
+    replayClock = static_cast<double>(time(nullptr) / 60 * 60);
+    lastAdviceUpdate = wallTime();
+
+    // Synthetic background, through the same post-process, upload and fade path
+    SDL_Surface* source = makeReplayBackground(1920, 1080);
+    if (source) {
+        backgroundManager->showImage(source, screenWidth, screenHeight, "replay");
+        SDL_FreeSurface(source);
+    }
+    return true;
+}
+
+time_t Clock::wallTime() const {
+    return options.headless ? static_cast<time_t>(replayClock) : time(nullptr);
+}
+
+void Clock::runFrame(float dt) {
+    {
+        ScopedPhase phase(profiler, FramePhase::EVENTS);
+        handleEvents();
+    }
+    profiler->beginFrame(false);
+    ScopedPhase phase(profiler, FramePhase::FRAME);
+    update(dt);
+    draw();
+}
+
+int Clock::runHeadless() {
+    const float dt = 1.0f / 60.0f;   // Fixed step, independent of how fast frames run
+    const int warmupFrames = 60;     // At least this many, for the caches to fill
+    const Uint32 warmupLimitMs = 10000;
+    LOG_INFO("Headless replay: %d frames at %dx%d, seed %u", options.frames, screenWidth, screenHeight,
+             static_cast<unsigned>(options.seed));
+
+    // Warm up until the background fade is over too: it runs on SDL_GetTicks,
+    // so how many frames it spans depends on the machine. The simulated clock
+    // stands still meanwhile, so the warm-up length cannot move a rollover.
+    const Uint32 warmupStart = SDL_GetTicks();
+    int warmed = 0;
+    while (running && (warmed < warmupFrames || backgroundManager->isTransitioning())) {
+        if (SDL_GetTicks() - warmupStart > warmupLimitMs) {
+            LOG_WARNING("Headless replay: background still fading after %u ms, measuring anyway", warmupLimitMs);
+            break;
+        }
+        runFrame(dt);
+        ++warmed;
+    }
+    LOG_DEBUG("Headless replay: %d warm-up frames", warmed);
+
+    const uint64_t allocationsAtStart = allocationCount();
+    const uint64_t bytesAtStart = allocatedBytes();
+    const auto measureStart = std::chrono::steady_clock::now();
+    int measuredFrames = 0;
+    for (; measuredFrames < options.frames && running; ++measuredFrames) {
+        runFrame(dt);
+        replayClock += dt;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - measureStart).count();
+    const uint64_t allocations = allocationCount() - allocationsAtStart;
+    const uint64_t allocationBytes = allocatedBytes() - bytesAtStart;
+
+    const double p99 = profiler->histogram(FramePhase::FRAME).percentile(0.99) / 1000.0;
+    if (allocationCountingEnabled()) {
+        LOG_INFO("Headless replay: %d frames in %.2f s (%.1f FPS), frame p99 %.2f ms, %.1f allocations/frame",
+                 measuredFrames, seconds, seconds > 0 ? measuredFrames / seconds : 0.0, p99,
+                 measuredFrames > 0 ? static_cast<double>(allocations) / measuredFrames : 0.0);
+    } else {
+        LOG_INFO("Headless replay: %d frames in %.2f s (%.1f FPS), frame p99 %.2f ms",
+                 measuredFrames, seconds, seconds > 0 ? measuredFrames / seconds : 0.0, p99);
+    }
+
+    if (!options.reportPath.empty() && !writeReport(seconds, allocations, allocationBytes, measuredFrames)) {
+        return 1;
+    }
+    if (options.frameBudgetMs > 0.0 && p99 > options.frameBudgetMs) {
+        LOG_ERROR("Frame p99 %.2f ms exceeds the %.2f ms budget", p99, options.frameBudgetMs);
+        return 2;
+    }
+    return 0;
+}
+
+bool Clock::writeReport(double seconds, uint64_t allocations, uint64_t allocationBytes, int measuredFrames) {
+    using json = nlohmann::json;
+    json report;
+    report["width"] = screenWidth;
+    report["height"] = screenHeight;
+    report["frames"] = measuredFrames;
+    report["seed"] = options.seed;
+    report["seconds"] = seconds;
+    report["fps"] = seconds > 0 ? measuredFrames / seconds : 0.0;
+    report["snow_kernel"] = snowKernelName();
+
+    // Phases include the warm-up frames
+    json phases = json::object();
+    for (size_t p = 0; p < static_cast<size_t>(FramePhase::COUNT); ++p) {
+        const FramePhase phase = static_cast<FramePhase>(p);
+        const DurationHistogram& hist = profiler->histogram(phase);
+        phases[FrameProfiler::phaseName(phase)] = {
+            {"samples", hist.count()},
+            {"mean_ms", hist.count() ? hist.sumMicros() / 1000.0 / hist.count() : 0.0},
+            {"p50_ms", hist.percentile(0.50) / 1000.0},
+            {"p95_ms", hist.percentile(0.95) / 1000.0},
+            {"p99_ms", hist.percentile(0.99) / 1000.0},
+            {"max_ms", hist.maxMicros() / 1000.0},
+        };
+    }
+    report["phases"] = phases;
+
+    // Null unless built with CLOCK_COUNT_ALLOCATIONS
+    report["allocations"] = nullptr;
+    if (allocationCountingEnabled()) {
+        report["allocations"] = {
+            {"count", allocations},
+            {"bytes", allocationBytes},
+            {"per_frame", measuredFrames > 0 ? static_cast<double>(allocations) / measuredFrames : 0.0},
+        };
+    }
+
+    TextCacheStats cache = display->getCacheStats();
+    report["text_cache"] = {
+        {"entries", cache.entries},
+        {"resident_bytes", cache.residentBytes},
+        {"hits", cache.hits},
+        {"misses", cache.misses},
+        {"evictions", cache.evictions},
+        {"layouts", cache.layouts},
+        {"layout_bytes", cache.layoutBytes},
+    };
+    report["rss_kb"] = Logger::instance().getMemoryUsageKB();
+
+    std::ofstream out(options.reportPath);
+    if (!(out << report.dump(2) << '\n')) {
+        LOG_ERROR("Failed to write report to %s", options.reportPath.c_str());
+        return false;
+    }
+    LOG_INFO("Headless replay report written to %s", options.reportPath.c_str());
+    return true;
 }
 
 void Clock::handleEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
+        // Only events that can change the picture force a redraw; mouse
+        // motion and the like must not wake an IDLE clock
+        bool redraw = false;
         if (event.type == SDL_QUIT) {
             running = false;
+        } else if (FrameScheduler::isWakeEvent(event)) {
+            redraw = true; // A worker published new data
         } else if (event.type == SDL_WINDOWEVENT) {
             if (event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED) {
                 SDL_ShowCursor(SDL_DISABLE);
             }
+            redraw = true; // Exposed, resized, shown...
+        } else if (event.type == SDL_RENDER_TARGETS_RESET) {
+            redraw = true;
+            // Target texture contents were lost
+            if (textLayer) textLayer->invalidate();
+            if (adviceLayer) adviceLayer->invalidate();
+        } else if (event.type == SDL_RENDER_DEVICE_RESET) {
+            // Every texture is gone: the background is reloaded from its disk
+            // cache, text textures are recreated as they are drawn
+            redraw = true;
+            LOG_WARNING("Render device reset, recreating textures");
+            backgroundManager->handleRenderReset();
+            display->recreateTextures();
+            snow->recreateTextures();
+            if (textLayer) {
+                createTextLayers(); // Text is drawn directly if this fails
+            }
+        }
+
+        if (redraw) {
+            scheduler->invalidate();
         }
     }
 }
@@ -161,27 +575,41 @@ bool Clock::shouldUpdateAdvice() const {
     return difftime(currentTime, lastAdviceUpdate) > adviceUpdateInterval;
 }
 
-void Clock::update() {
-    snow->update(); // Update snow physics
-    backgroundManager->update(SCREEN_WIDTH, SCREEN_HEIGHT);
+void Clock::update(float dt) {
+    ScopedPhase updatePhase(profiler, FramePhase::UPDATE);
+    {
+        ScopedPhase phase(profiler, FramePhase::SNOW_UPDATE);
+        snow->update(dt); // Update snow physics
+    }
+    backgroundManager->update(screenWidth, screenHeight);
 
     // Check if weather data is valid *before* deciding to update advice
     if (weatherAPI->isDataValid()) {
-        // Only update advice if data is valid AND the interval has passed
-        if (shouldUpdateAdvice()) {
-            WeatherData currentWeatherData = weatherAPI->getWeather();
-            clothingAdvice = getClothingAdvice(
-                currentWeatherData.temperature,
-                currentWeatherData.weathercode,
-                currentWeatherData.windspeed,
-                CLOTHING_ADVICE_LANGUAGE
-            );
-            time(&lastAdviceUpdate); // Update timestamp only after successful advice fetch
+        // Only request advice if data is valid AND the interval has passed.
+        // The request runs on the advice worker; the current advice stays on
+        // screen until the new one arrives.
+        if (adviceService && shouldUpdateAdvice()) {
+            adviceService->requestAdvice(weatherAPI->getWeather());
+            time(&lastAdviceUpdate);
+        }
+        // New forecast: prepare the coming hours' advice while the link is idle
+        uint64_t version = weatherAPI->getDataVersion();
+        if (adviceService && version != forecastVersion) {
+            forecastVersion = version;
+            adviceService->prefetchForecast(weatherAPI->getWeather());
         }
     } else if (clothingAdvice.empty()) {
         // Optional: Set a temporary message while waiting for the first fetch
         // This prevents showing nothing while waiting for the initial data.
         clothingAdvice = "Получение данных..."; // Or "Loading data..."
+        if (adviceLayer) adviceLayer->invalidate();
+    }
+
+    // Pick up finished advice without blocking
+    std::string newAdvice;
+    if (adviceService && adviceService->pollAdvice(newAdvice)) {
+        clothingAdvice = std::move(newAdvice);
+        if (adviceLayer) adviceLayer->invalidate();
     }
 }
 
@@ -189,76 +617,128 @@ void Clock::draw() {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    backgroundManager->draw(renderer);
-    snow->draw(renderer);
+    {
+        ScopedPhase phase(profiler, FramePhase::BACKGROUND);
+        backgroundManager->draw(renderer);
+    }
+    if (backgroundManager->isTransitioning()) {
+        scheduler->invalidate(); // Keep frames coming until the upload and fade finish (IDLE mode)
+    }
+    {
+        ScopedPhase phase(profiler, FramePhase::SNOW_DRAW);
+        snow->draw(renderer);
+    }
+
+    ScopedPhase textPhase(profiler, FramePhase::TEXT);
+
+    // Preformatted; rebuilt only when the minute or the weather changes
+    const bool textChanged = textModel.refresh(wallTime(), *weatherAPI);
 
-    // Get current time
-    auto now = std::chrono::system_clock::now();
-    std::time_t currentTime = std::chrono::system_clock::to_time_t(now);
-    std::tm *now_tm = std::localtime(&currentTime);
+    if (textLayer) {
+        // Text sits above the snow and changes about once a minute: redraw it
+        // into the layer only then, and composite it with one copy per frame.
+        // The advice has a layer of its own, so its string textures are not
+        // needed (and may expire from the cache) between advice updates.
+        if (textChanged) {
+            textLayer->invalidate();
+        }
+        if (textLayer->needsRebuild() && textLayer->beginRebuild()) {
+            drawText();
+            textLayer->endRebuild();
+        }
+        if (adviceLayer->needsRebuild() && adviceLayer->beginRebuild()) {
+            drawAdvice(adviceY() - adviceLayerTop); // Same screen position as without layers
+            adviceLayer->endRebuild();
+        }
+        textLayer->draw();
+        adviceLayer->draw();
+    } else {
+        drawText();
+        drawAdvice(adviceY());
+    }
+
+    display->updateFps();
+    display->renderFps();
+    display->cleanupCache();
+    textPhase.stop();
 
+    ScopedPhase presentPhase(profiler, FramePhase::PRESENT);
+    SDL_RenderPresent(renderer);
+}
+
+void Clock::drawText() {
     TextStyle defaultStyle;
     defaultStyle.color = WHITE_COLOR;
     defaultStyle.alignment = TextAlign::CENTER;
     defaultStyle.withShadow = true;
 
     // Draw time
-    std::stringstream timeStream;
-    timeStream << std::setfill('0') << std::setw(2) << now_tm->tm_hour
-            << ":" << std::setfill('0') << std::setw(2) << now_tm->tm_min;
     display->renderText(
-        timeStream.str(),
+        textModel.timeText(),
         FontSize::LARGE,
         defaultStyle,
-        SCREEN_WIDTH / 2,
-        SCREEN_HEIGHT / 2 - SCREEN_HEIGHT / 10
+        screenWidth / 2,
+        screenHeight / 2 - screenHeight / 10
     );
 
     // Draw date
-    std::stringstream dateStream;
-    dateStream << WEEKDAYS_RU.at(now_tm->tm_wday) << ", "
-            << now_tm->tm_mday << " "
-            << MONTHS_RU.at(now_tm->tm_mon + 1) << " "
-            << (now_tm->tm_year + 1900) << " года";
     display->renderText(
-        dateStream.str(),
+        textModel.dateText(),
         FontSize::SMALL,
         defaultStyle,
-        SCREEN_WIDTH / 2,
-        SCREEN_HEIGHT * 0.075
+        screenWidth / 2,
+        screenHeight * 0.075
     );
 
     // Draw weather
-    WeatherData currentWeatherData = weatherAPI->getWeather();
-    std::string weatherStr = getWeatherDescription(
-        currentWeatherData.temperature,
-        currentWeatherData.weathercode,
-        currentWeatherData.windspeed
-    );
-    int weatherY = SCREEN_HEIGHT * 0.75;
+    int weatherY = screenHeight * 0.75;
     display->renderText(
-        weatherStr,
+        textModel.weatherText(),
         FontSize::SMALL,
         defaultStyle,
-        SCREEN_WIDTH / 2,
+        screenWidth / 2,
         weatherY
     );
 
-    // Draw clothing advice
+}
+
+int Clock::adviceY() const {
+    return static_cast<int>(screenHeight * 0.75) + display->getLineSkip(FontSize::SMALL); // One line below the weather
+}
+
+void Clock::drawAdvice(int y) {
+    // Long and static, so kept as whole-line textures
     if (!clothingAdvice.empty()) {
-        int adviceY = weatherY + 60; // Approximate line skip
+        TextStyle adviceStyle;
+        adviceStyle.color = WHITE_COLOR;
+        adviceStyle.alignment = TextAlign::CENTER;
+        adviceStyle.withShadow = true;
+        adviceStyle.staticText = true;
         display->renderMultilineText(
             clothingAdvice,
             FontSize::EXTRA_SMALL,
-            defaultStyle,
-            SCREEN_WIDTH / 2,
-            adviceY
+            adviceStyle,
+            screenWidth / 2,
+            y
         );
     }
+}
 
-    display->updateFps();
-    display->renderFps();
-    display->cleanupCache();
-
-    SDL_RenderPresent(renderer);
+bool Clock::createTextLayers() {
+    if (!textLayer) textLayer = new RenderLayer();
+    if (!adviceLayer) adviceLayer = new RenderLayer();
+
+    // The advice layer covers the screen from the top of the first advice
+    // line (its blurred shadow included) down
+    adviceLayerTop = std::max(0, adviceY() + display->getMultilineTop(FontSize::EXTRA_SMALL, true));
+    adviceLayer->setPosition(0, adviceLayerTop);
+    if (textLayer->initialize(renderer, screenWidth, screenHeight) &&
+        adviceLayer->initialize(renderer, screenWidth, screenHeight - adviceLayerTop)) {
+        return true;
+    }
+    delete textLayer;
+    textLayer = nullptr;
+    delete adviceLayer;
+    adviceLayer = nullptr;
+    return false;
 }
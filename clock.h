@@ -4,20 +4,52 @@
 
 #include <SDL2/SDL.h>
 #include <string>
+#include <chrono>
+#include <cstdint>
+#include "display_model.h"
+#include "config.h"
 
 class Display;
 class SnowSystem;
 class WeatherAPI;
 class BackgroundManager;
+class AdviceService;
+class FrameScheduler;
+class IOExecutor;
+class FrameProfiler;
+class MetricsServer;
+class RenderLayer;
+class QualityGovernor;
+
+// Command-line options (see main.cpp)
+struct ClockOptions {
+    int width = 0;                 // 0 = SCREEN_WIDTH
+    int height = 0;                // 0 = SCREEN_HEIGHT
+    RenderBackend backend = RENDER_BACKEND;   // Ignored in headless mode
+
+    // Headless replay: offscreen (SDL dummy driver, software renderer), recorded
+    // fixtures instead of the network, a fixed 60 Hz step, a simulated wall
+    // clock and a seeded snow field; after a warm-up, runs a set number of
+    // measured frames as fast as possible
+    bool headless = false;
+    int frames = 600;
+    uint32_t seed = 1;
+    std::string fixtureDir = "bench/fixtures";
+    std::string reportPath;        // JSON report; empty to only log the summary
+    double frameBudgetMs = 0.0;    // Fail the run when frame p99 exceeds this (0 = no gate)
+};
 
 class Clock {
 public:
-    Clock();
+    explicit Clock(const ClockOptions& options = ClockOptions());
     ~Clock();
     bool initialize();
-    void run();
+    int run();  // Process exit code
 
 private:
+    ClockOptions options;
+    int screenWidth;
+    int screenHeight;
     bool running;
     SDL_Window* window;
     SDL_Renderer* renderer;
@@ -25,14 +57,37 @@ private:
     SnowSystem* snow;
     WeatherAPI* weatherAPI;
     BackgroundManager* backgroundManager;
+    AdviceService* adviceService;
+    FrameScheduler* scheduler;
+    IOExecutor* ioExecutor;   // Runs all network jobs; outlives the subsystems using it
+    FrameProfiler* profiler;  // Null unless FRAME_PROFILING_ENABLED or METRICS_ENABLED
+    MetricsServer* metricsServer;  // Null unless METRICS_ENABLED
+    RenderLayer* textLayer;   // Cached text above the snow; null when drawing it directly
+    RenderLayer* adviceLayer; // Advice only, rebuilt when it changes rather than every minute
+    int adviceLayerTop;       // Screen y of adviceLayer's top edge
+    QualityGovernor* snowGovernor;  // Null unless SNOW_GOVERNOR_ENABLED (never in headless mode)
     time_t lastAdviceUpdate;
     int adviceUpdateInterval;
+    uint64_t forecastVersion;  // Weather data version last handed to the advice prefetch
     std::string clothingAdvice;
+    DisplayModel textModel;   // Time, date and weather strings for draw()
+    std::chrono::steady_clock::time_point startTime;   // For time-to-first-frame
+    bool firstFrameDrawn;
+    double replayClock;       // Headless: simulated wall time in seconds, advanced by the fixed step
 
+    bool initializeReplayData();
+    int runHeadless();
+    bool writeReport(double seconds, uint64_t allocations, uint64_t allocationBytes, int measuredFrames);
+    void runFrame(float dt);
+    time_t wallTime() const;  // time(nullptr), or the simulated clock in headless mode
     void handleEvents();
     bool shouldUpdateAdvice() const;
-    void update();
+    void update(float dt);
     void draw();
+    void drawText();
+    void drawAdvice(int y);
+    int adviceY() const;
+    bool createTextLayers();
 };
 
 #endif // CLOCK_H
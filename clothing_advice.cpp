@@ -6,10 +6,13 @@
 #include "logger.h"
 #include <string>
 #include <sstream>
-#include <httplib.h>
+#include "http_client.h"
 #include <nlohmann/json.hpp>
+#include <cmath>
+#include <cstdio>
 #include <ctime>
 #include <iomanip>
+#include <limits>
 #include <iostream> // For std::cerr
 
 using json = nlohmann::json;
@@ -28,101 +31,192 @@ std::string getBasicAdvice(double temperature) {
     }
 }
 
-// Updated function signature to match header (apiKey removed)
-std::string getClothingAdvice(double temperature, int weathercode, double windspeed, const char* language) {
-// API Key is now read directly from constants.h/cpp via CEREBRAS_API_KEY
-if (!CEREBRAS_API_KEY || std::string(CEREBRAS_API_KEY).empty()) {
-    LOG_WARNING("Cerebras API Key is not configured. Falling back to basic advice.");
-    return getBasicAdvice(temperature);
+namespace {
+
+// Weather for one slot as the model sees it: the on-screen description (with
+// windspeed) plus the hourly feels-like and precipitation when known
+std::string describeSlot(const AdviceForecastSlot& slot) {
+    std::string text(getWeatherDescription(slot.temperature, slot.weathercode, slot.windspeed, true));
+    char extra[64];
+    if (!std::isnan(slot.apparentTemperature)) {
+        std::snprintf(extra, sizeof(extra), ", feels like %.0f°C", slot.apparentTemperature);
+        text += extra;
+    }
+    if (!std::isnan(slot.precipitation) && slot.precipitation > 0.0) {
+        std::snprintf(extra, sizeof(extra), ", %.1f mm precipitation", slot.precipitation);
+        text += extra;
+    }
+    return text;
 }
 
-    std::time_t t = std::time(nullptr);
-    std::tm* now = std::localtime(&t);
-    std::stringstream monthStream;
-    monthStream << std::put_time(now, "%B");
-    std::string currentMonth = monthStream.str();
-    std::stringstream timeStream;
-    timeStream << std::put_time(now, "%H:%M");
-    std::string currentTime = timeStream.str();
+std::string formatTime(time_t when, const char* format) {
+    std::tm local;
+    localtime_r(&when, &local);
+    std::stringstream stream;
+    stream << std::put_time(&local, format);
+    return stream.str();
+}
 
-    // Pass true to getWeatherDescription to include windspeed details for the LLM
-    std::string weatherDesc = getWeatherDescription(temperature, weathercode, windspeed, true);
+// The one prompt for both request shapes. A single request describes the
+// current weather and asks for one sentence; a batch lists numbered forecast
+// hours and asks for a JSON array of sentences in the same order.
+std::string buildAdvicePayload(const std::vector<AdviceForecastSlot>& slots, const char* language, bool batch) {
+    const std::time_t now = std::time(nullptr);
+    std::tm today;
+    localtime_r(&now, &today);
+
+    std::string prompt = "I live in Amsterdam.\n" // Keep location context if useful for the model
+                         "Today is " + std::to_string(today.tm_mday) + " " + formatTime(now, "%B") + ", \n";
+    if (!batch) {
+        prompt += "the time is " + formatTime(now, "%H:%M") + ", \n"
+                  "and the weather is: " + describeSlot(slots.front()) + ". \n"
+                  "What should I wear? \n"
+                  "Please answer in one short sentence, using this locale: " + std::string(language) + ".\n";
+    } else {
+        prompt += "and here is the weather forecast for the coming hours:\n";
+        for (size_t i = 0; i < slots.size(); ++i) {
+            prompt += std::to_string(i + 1) + ". at " + formatTime(slots[i].when, "%H:%M") + ": " +
+                      describeSlot(slots[i]) + "\n";
+        }
+        prompt += "For each numbered forecast, what should I wear? \n"
+                  "Please answer each in one short sentence, using this locale: " + std::string(language) + ".\n";
+    }
+    prompt += "Only say what clothes I should wear, there's no need to mention city, current weather or time and date.\n"
+              "Basically, just continue the phrase: You should wear..., without saying the 'you should wear' part.\n";
+    if (batch) {
+        prompt += "Reply with only a JSON array of " + std::to_string(slots.size()) +
+                  " strings, in the same order as the forecasts.\n";
+    }
 
     json payload = {
         {"model", CEREBRAS_MODEL},
-        {"max_tokens", 300}, // Adjusted max_tokens, 312 might be too long for just clothing advice
+        // 300 for one sentence; a batch gets about 80 per extra slot
+        {"max_tokens", batch ? 100 + 80 * static_cast<int>(slots.size()) : 300},
         {"temperature", 0.7}, // Slightly increased temperature for potentially more varied advice
         {"messages", {
             {{"role", "system"}, {"content", "You are a helpful assistant providing concise clothing advice."}},
-            {{"role", "user"}, {"content",
-                "I live in Amsterdam.\n" // Keep location context if useful for the model
-                "Today is " + std::to_string(now->tm_mday) + " " + currentMonth + ", \n"
-                "the time is " + currentTime + ", \n"
-                "and the weather is: " + weatherDesc + ". \n"
-                "What should I wear? \n"
-                "Please answer in one short sentence, using this locale: " + std::string(language) + ".\n"
-                "Only say what clothes I should wear, there's no need to mention city, current weather or time and date.\n"
-                "Basically, just continue the phrase: You should wear..., without saying the 'you should wear' part.\n"
-            }}
+            {{"role", "user"}, {"content", prompt}}
         }}
     };
 
-try {
-    // Use SSLClient for HTTPS connection to Cerebras
-    httplib::SSLClient cli(CEREBRAS_API_HOST, CEREBRAS_API_PORT);
-    cli.set_connection_timeout(10); // 10 seconds
-    cli.set_read_timeout(10);
+    return payload.dump();
+}
 
-    httplib::Headers headers = {
-        {"Content-Type", "application/json"},
-        {"Authorization", std::string("Bearer ") + CEREBRAS_API_KEY},
-    };
+} // namespace
 
-    // Post to the Cerebras API path
-    auto res = cli.Post(CEREBRAS_API_PATH, headers, payload.dump(), "application/json");
-
-    if (res) {
-        if (res->status == 200) {
-            try {
-                nlohmann::json j = nlohmann::json::parse(res->body);
-                // Check for Cerebras specific error structure if needed, or general structure
-                if (j.contains("error")) {
-                    std::string errorMsg = j["error"].dump();
-                    LOG_ERROR("Cerebras API Error: %s", errorMsg.c_str());
-                    return getBasicAdvice(temperature);
-                }
-                // Add proper validation before accessing nested JSON fields
-                if (j.contains("choices") && !j["choices"].empty()) {
-                    auto& choice = j["choices"][0];
-                    if (choice.contains("message") && choice["message"].contains("content")) {
-                        auto& content = choice["message"]["content"];
-                        // Check if content is not null and is a string
-                        if (!content.is_null() && content.is_string()) {
-                            std::string advice = content.get<std::string>();
-                            return !advice.empty() ? advice : getBasicAdvice(temperature);
-                        }
+std::string buildClothingAdvicePayload(double temperature, int weathercode, double windspeed, const char* language) {
+    const double unknown = std::numeric_limits<double>::quiet_NaN();
+    return buildAdvicePayload({{std::time(nullptr), temperature, weathercode, windspeed, unknown, unknown}},
+                              language, false);
+}
+
+std::string parseClothingAdviceResponse(const std::string& body, double temperature, bool* fromModel) {
+    if (fromModel) *fromModel = false;
+    try {
+        nlohmann::json j = nlohmann::json::parse(body);
+        // Check for Cerebras specific error structure if needed, or general structure
+        if (j.contains("error")) {
+            std::string errorMsg = j["error"].dump();
+            LOG_ERROR("Cerebras API Error: %s", errorMsg.c_str());
+            return getBasicAdvice(temperature);
+        }
+        // Add proper validation before accessing nested JSON fields
+        if (j.contains("choices") && !j["choices"].empty()) {
+            auto& choice = j["choices"][0];
+            if (choice.contains("message") && choice["message"].contains("content")) {
+                auto& content = choice["message"]["content"];
+                // Check if content is not null and is a string
+                if (!content.is_null() && content.is_string()) {
+                    std::string advice = content.get<std::string>();
+                    if (advice.empty()) {
+                        return getBasicAdvice(temperature);
                     }
+                    if (fromModel) *fromModel = true;
+                    return advice;
                 }
-                LOG_ERROR("Invalid or empty response from Cerebras API");
-                return getBasicAdvice(temperature);
-            } catch (const nlohmann::json::parse_error &e) {
-                LOG_ERROR("Error processing Cerebras JSON response: %s", e.what());
-                return getBasicAdvice(temperature);
-            } catch (const std::exception &e) {
-                LOG_ERROR("Error extracting content from response: %s", e.what());
-                return getBasicAdvice(temperature);
             }
         }
-    } else {
-        auto err = res.error();
-        LOG_ERROR("HTTP request failed: %s", httplib::to_string(err).c_str());
+        LOG_ERROR("Invalid or empty response from Cerebras API");
+        return getBasicAdvice(temperature);
+    } catch (const nlohmann::json::parse_error &e) {
+        LOG_ERROR("Error processing Cerebras JSON response: %s", e.what());
+        return getBasicAdvice(temperature);
+    } catch (const std::exception &e) {
+        LOG_ERROR("Error extracting content from response: %s", e.what());
         return getBasicAdvice(temperature);
     }
-} catch (const std::exception &e) {
-    LOG_ERROR("An unexpected error occurred: %s", e.what());
-    return getBasicAdvice(temperature);
 }
 
+std::string buildClothingAdviceBatchPayload(const std::vector<AdviceForecastSlot>& slots, const char* language) {
+    return buildAdvicePayload(slots, language, true);
+}
+
+bool parseClothingAdviceBatchResponse(const std::string& body, size_t slotCount, std::vector<std::string>& advice) {
+    advice.clear();
+    json j = json::parse(body, nullptr, false);
+    if (j.is_discarded() || !j.contains("choices") || !j["choices"].is_array() || j["choices"].empty()) {
+        LOG_ERROR("Invalid batch response from Cerebras API");
+        return false;
+    }
+    const json& choice = j["choices"][0];
+    if (!choice.contains("message") || !choice["message"].contains("content") ||
+        !choice["message"]["content"].is_string()) {
+        LOG_ERROR("Batch response from Cerebras API has no content");
+        return false;
+    }
+
+    // The array may come wrapped in prose or a code fence
+    const std::string content = choice["message"]["content"].get<std::string>();
+    const size_t open = content.find('[');
+    const size_t close = content.rfind(']');
+    if (open == std::string::npos || close == std::string::npos || close < open) {
+        LOG_WARNING("Batch advice is not a JSON array");
+        return false;
+    }
+    json list = json::parse(content.substr(open, close - open + 1), nullptr, false);
+    if (!list.is_array() || list.size() != slotCount) {
+        LOG_WARNING("Batch advice has %zu entries, expected %zu",
+                    list.is_array() ? list.size() : static_cast<size_t>(0), slotCount);
+        return false;
+    }
+    for (const auto& item : list) {
+        if (!item.is_string() || item.get<std::string>().empty()) {
+            advice.clear();
+            return false;
+        }
+        advice.push_back(item.get<std::string>());
+    }
+    return true;
+}
+
+std::string getClothingAdvice(double temperature, int weathercode, double windspeed, const char* language) {
+    // API Key is now read directly from constants.h/cpp via CEREBRAS_API_KEY
+    if (!CEREBRAS_API_KEY || std::string(CEREBRAS_API_KEY).empty()) {
+        LOG_WARNING("Cerebras API Key is not configured. Falling back to basic advice.");
+        return getBasicAdvice(temperature);
+    }
+
+    std::string payload = buildClothingAdvicePayload(temperature, weathercode, windspeed, language);
+
+    // Shared keep-alive client for the Cerebras host (same one AdviceService uses)
+    auto client = HTTPClient::forHost(CEREBRAS_API_HOST, CEREBRAS_API_PORT);
+
+    httplib::Headers headers = {
+        {"Authorization", std::string("Bearer ") + CEREBRAS_API_KEY},
+    };
+
+    // Post to the Cerebras API path
+    auto res = client->post(CEREBRAS_API_PATH, payload, "application/json", headers, 10);
+
+    if (res.statusCode == 200) {
+        return parseClothingAdviceResponse(res.body, temperature);
+    }
+    if (res.statusCode != 0) {
+        LOG_ERROR("Cerebras API returned status %d", res.statusCode);
+    } else {
+        LOG_ERROR("HTTP request failed: %s", res.error.c_str());
+    }
+
     // Fallback to basic advice if API call fails or returns empty/invalid data
     return getBasicAdvice(temperature);
 }
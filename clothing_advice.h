@@ -2,10 +2,33 @@
 #ifndef CLOTHING_ADVICE_H
 #define CLOTHING_ADVICE_H
 
+#include <ctime>
 #include <string>
+#include <vector>
 
-// Updated function signature: apiKey parameter removed
+// Blocking helper: builds the prompt, calls Cerebras and parses the answer.
+// Do not call from the render thread - use AdviceService instead.
 std::string getClothingAdvice(double temperature, int weathercode, double windspeed, const char* language = "ru");
 std::string getBasicAdvice(double temperature);
 
+// Request/response halves of getClothingAdvice(), used by AdviceService so it can
+// own (and abort) the HTTP connection itself
+std::string buildClothingAdvicePayload(double temperature, int weathercode, double windspeed, const char* language);
+// fromModel (optional) is set to false when the basic advice was substituted
+std::string parseClothingAdviceResponse(const std::string& body, double temperature, bool* fromModel = nullptr);
+
+// Batched prefetch: one request asking for advice for several forecast hours.
+// Both payloads share one prompt; the batch one numbers the slots.
+struct AdviceForecastSlot {
+    time_t when;
+    double temperature;
+    int weathercode;
+    double windspeed;
+    double apparentTemperature;  // °C; NaN if unknown
+    double precipitation;        // mm; NaN if unknown
+};
+std::string buildClothingAdviceBatchPayload(const std::vector<AdviceForecastSlot>& slots, const char* language);
+// Fills advice with one entry per slot; false unless the model answered for every slot
+bool parseClothingAdviceBatchResponse(const std::string& body, size_t slotCount, std::vector<std::string>& advice);
+
 #endif // CLOTHING_ADVICE_H
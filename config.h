@@ -11,6 +11,13 @@
 const int SCREEN_WIDTH = 1024;
 const int SCREEN_HEIGHT = 600;
 
+// Display backend, picked at startup (--backend overrides it)
+enum class RenderBackend {
+    SDL_DEFAULT,  // Whatever SDL chooses (X11 or Wayland under a desktop session)
+    KMSDRM        // Direct to the display via KMS/DRM (GBM/EGL, page flips) with the GLES2 renderer
+};
+const RenderBackend RENDER_BACKEND = RenderBackend::SDL_DEFAULT;
+
 // Colors
 const SDL_Color WHITE_COLOR = {255, 255, 255, 255};
 const SDL_Color BLACK_COLOR = {0, 0, 0, 255};
@@ -19,11 +26,75 @@ const SDL_Color SHADOW_COLOR = {0, 0, 0, 30}; // Much lower alpha for soft shado
 // Text Shadow configuration
 // const int SHADOW_OFFSET_X = 2; // Removed
 // const int SHADOW_OFFSET_Y = 2; // Removed
-const int SHADOW_RADIUS = 3;       // Radius for the soft shadow spread (adjust as needed)
-const int SHADOW_SAMPLES = 4;      // Reduced layers for soft shadow (adjust for quality/performance)
+// Only the advice (static text, baked into its texture once) gets the blurred
+// shadow. Time, date and weather use the glyph atlases, whose shadow is a hard
+// offset copy of the glyphs. Both use SHADOW_ALPHA, so they match in strength.
+const Uint8 SHADOW_ALPHA = 128;    // Opacity of every text shadow
+const int SHADOW_RADIUS = 3;       // Box blur radius of the baked text shadow (per pass)
+const int SHADOW_SAMPLES = 2;      // Box blur passes for the baked text shadow (2 ~ tent, 3 ~ gaussian)
+
+// Frame scheduling
+enum class FrameMode {
+    FULL_RATE,  // Redraw every vsync
+    CAPPED,     // Redraw at FRAME_RATE_CAP
+    IDLE        // Redraw only on minute boundaries, data changes and window events; snow stays frozen
+};
+const FrameMode FRAME_MODE = FrameMode::FULL_RATE;
+const int FRAME_RATE_CAP = 30;     // FPS used in CAPPED mode (e.g. 30/20/10)
+const bool FRAME_PROFILING_ENABLED = false; // Per-phase frame timings in the heartbeat log
+
+// Prometheus /metrics endpoint (frame timings, caches, network health)
+const bool METRICS_ENABLED = false;
+const int METRICS_PORT = 9105;
+const char* const METRICS_BIND_ADDRESS = "0.0.0.0";
+
+// Background image transitions
+const int BACKGROUND_UPLOAD_ROWS_PER_FRAME = 64;   // Rows copied to the GPU per frame
+const Uint32 BACKGROUND_CROSSFADE_MS = 1000;       // Fade from the old image to the new one
+const size_t BACKGROUND_CACHE_ENTRIES = 3;         // Decoded backgrounds kept on disk
+const size_t BACKGROUND_MAX_DOWNLOAD_BYTES = 16 * 1024 * 1024; // Larger images are rejected mid-download
+
+// Network I/O: threads shared by weather, background and advice jobs
+const size_t IO_EXECUTOR_THREADS = 2;
+
+// Clothing advice cache and forecast prefetch
+const size_t ADVICE_CACHE_ENTRIES = 256;
+const int ADVICE_CACHE_TTL_SECONDS = 12 * 3600;    // Advice is reused for this long
+const int ADVICE_PREFETCH_HOURS = 6;               // Forecast hours to prepare advice for (also sizes the weather request)
+const size_t ADVICE_PREFETCH_BATCH = 6;            // Forecast hours per LLM request
+const int ADVICE_PREFETCH_INTERVAL_SECONDS = 3600; // At most one prefetch run per interval
+
+// Draw the on-screen text into a cached render-target layer and composite it
+// with one copy per frame instead of re-blending every glyph and shadow
+const bool LAYER_COMPOSITING_ENABLED = true;
+
+// Global limit for the memory tracked per subsystem (textures, decoded images,
+// snow, HTTP bodies). Only the text cache is limited by it: it shrinks to stay
+// within it, down to TEXT_CACHE_MIN_BYTES. For the other pools the limit is
+// advisory. They are counted and the heartbeat warns when the total is over,
+// but nothing is refused.
+const size_t MEMORY_BUDGET_BYTES = 64 * 1024 * 1024;   // 64MB
+
+// Text texture cache (whole-string textures; glyph atlases are not counted)
+const size_t TEXT_CACHE_MAX_BYTES = 50 * 1024 * 1024; // 50MB
+const size_t TEXT_CACHE_MIN_BYTES = 4 * 1024 * 1024;  // Kept even when the global budget is exhausted
+const int TEXT_CACHE_LIFETIME_SECONDS = 30;            // Drop textures unused for this long
 
 // Snow configuration
-const int NUM_SNOWFLAKES = 666;  // number of snowflakes
+const int NUM_SNOWFLAKES = 666;  // number of snowflakes (starting point when the governor is on)
+
+// Snow quality governor: scales the active flake count between these bounds
+// from measured frame intervals (FULL_RATE mode only; headless replay stays
+// at NUM_SNOWFLAKES)
+const bool SNOW_GOVERNOR_ENABLED = true;
+const int SNOW_MIN_FLAKES = 200;
+const int SNOW_MAX_FLAKES = 1332;
+
+// Threads simulating the next snow frame while the current one is drawn
+// (0 = simulate on the main thread; single-core devices always do). One
+// worker double-buffers the whole step; more only start for fields of at
+// least SnowSystem::PARALLEL_MIN_FLAKES, far above SNOW_MAX_FLAKES.
+const int SNOW_SIMULATION_THREADS = 1;
 
 // Russian language configurations
 extern const std::map<int, std::string> MONTHS_RU;
@@ -27,4 +27,9 @@ extern const int WEATHER_API_URL_PORT;
 extern const char* WEATHER_API_URL_PATH;
 extern const char* FONT_PATH;
 
+// On-disk caches (relative to the working directory)
+extern const char* FONT_METRICS_CACHE_PATH;
+extern const char* BACKGROUND_CACHE_DIR;
+extern const char* ADVICE_CACHE_PATH;
+
 #endif // CONSTANTS_H
@@ -1,11 +1,22 @@
 #include "display.h"
 #include "logger.h"
+#include "config.h"
+#include "constants.h"
+#include "font_metrics_cache.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 
-// Correct font path
-static const char* FONT_PATH = "assets/fonts/BellotaText-Bold.ttf";
+// Characters pre-rasterized for each atlas: the clock only needs digits and the
+// separator; date, weather and short labels use Latin, Cyrillic and punctuation
+static const char* LARGE_CHARSET = "0123456789:";
+static const char* TEXT_CHARSET =
+    " !\"#$%&'()*+,-./0123456789:;<=>?@"
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`"
+    "abcdefghijklmnopqrstuvwxyz{|}~"
+    "АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"
+    "абвгдеёжзийклмнопрстуфхцчшщъыьэюя"
+    "°«»–—…№";
 
 // Helper to create font unique_ptr with custom deleter
 static std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> makeFontPtr(TTF_Font* font) {
@@ -19,23 +30,69 @@ Display::Display(SDL_Renderer* renderer, int screenWidth, int screenHeight)
     , fontLarge(nullptr, TTF_CloseFont)
     , fontSmall(nullptr, TTF_CloseFont)
     , fontExtraSmall(nullptr, TTF_CloseFont)
+    , textRenderMode(TextRenderMode::GLYPH_ATLAS)
+    , layoutCacheMemory(0)
     , currentCacheMemory(0)
+    , maxCacheMemory(TEXT_CACHE_MAX_BYTES)
+    , textureCharge(MemoryPool::TEXT_CACHE, MemoryKind::GPU)
+    , layoutCharge(MemoryPool::TEXT_CACHE, MemoryKind::CPU)
+    , atlasCharge(MemoryPool::TEXT_CACHE, MemoryKind::GPU)
+    , cacheLifetimeSeconds(TEXT_CACHE_LIFETIME_SECONDS)
     , currentFps(0.0f)
     , showFps(false)
     , lastFrameTime(std::chrono::steady_clock::now())
     , frameCounter(0)
     , lastCacheCleanup(std::chrono::steady_clock::now())
 {
-    // Calculate and load fonts
-    int largeFontSize = calculateLargeFontSize();
+    // Font sizes depend only on the font file and resolution, so reuse them across boots
+    uint64_t fontHash = hashFontFile(FONT_PATH);
+    bool cached = loadFontMetrics(FONT_METRICS_CACHE_PATH, fontHash, screenWidth, screenHeight, metrics);
+    if (cached) {
+        LOG_INFO("Using cached font metrics (large font size %d)", metrics.largeSize);
+    } else {
+        metrics.largeSize = calculateLargeFontSize();
+        metrics.smallSize = std::max(1, metrics.largeSize / 8);
+        metrics.extraSmallSize = std::max(1, metrics.largeSize / 12);
+    }
 
-    fontLarge = makeFontPtr(loadFont(FONT_PATH, largeFontSize));
-    fontSmall = makeFontPtr(loadFont(FONT_PATH, std::max(1, largeFontSize / 8)));
-    fontExtraSmall = makeFontPtr(loadFont(FONT_PATH, std::max(1, largeFontSize / 12)));
+    fontLarge = makeFontPtr(loadFont(FONT_PATH, metrics.largeSize));
+    fontSmall = makeFontPtr(loadFont(FONT_PATH, metrics.smallSize));
+    fontExtraSmall = makeFontPtr(loadFont(FONT_PATH, metrics.extraSmallSize));
 
     if (!fontLarge || !fontSmall || !fontExtraSmall) {
         LOG_WARNING("Failed to load one or more fonts");
+    } else {
+        metrics.largeLineSkip = TTF_FontLineSkip(fontLarge.get());
+        metrics.smallLineSkip = TTF_FontLineSkip(fontSmall.get());
+        metrics.extraSmallLineSkip = TTF_FontLineSkip(fontExtraSmall.get());
+        if (!cached && !saveFontMetrics(FONT_METRICS_CACHE_PATH, fontHash, screenWidth, screenHeight, metrics)) {
+            LOG_WARNING("Could not persist font metrics to %s", FONT_METRICS_CACHE_PATH);
+        }
     }
+
+    buildGlyphAtlases();
+}
+
+void Display::buildGlyphAtlases() {
+    atlasLarge.build(renderer, fontLarge.get(), LARGE_CHARSET);
+    atlasSmall.build(renderer, fontSmall.get(), TEXT_CHARSET);
+    atlasExtraSmall.build(renderer, fontExtraSmall.get(), TEXT_CHARSET);
+    atlasCharge.resize(atlasLarge.getMemorySize() + atlasSmall.getMemorySize() + atlasExtraSmall.getMemorySize());
+
+    LOG_INFO("Glyph atlases ready: large=%s small=%s extra-small=%s",
+             atlasLarge.isReady() ? "yes" : "no",
+             atlasSmall.isReady() ? "yes" : "no",
+             atlasExtraSmall.isReady() ? "yes" : "no");
+}
+
+const GlyphAtlas* Display::getAtlas(FontSize size) const {
+    const GlyphAtlas* atlas = nullptr;
+    switch (size) {
+        case FontSize::LARGE: atlas = &atlasLarge; break;
+        case FontSize::SMALL: atlas = &atlasSmall; break;
+        case FontSize::EXTRA_SMALL: atlas = &atlasExtraSmall; break;
+    }
+    return (atlas && atlas->isReady()) ? atlas : nullptr;
 }
 
 Display::~Display() {
@@ -61,34 +118,68 @@ int Display::calculateLargeFontSize() {
     LOG_DEBUG("Screen size: %dx%d", screenWidth, screenHeight);
     LOG_DEBUG("Target height: %d, max width: %d", targetHeight, maxWidth);
 
-    // Use the original linear search approach
-    int testSize = 100;
-    int lastGoodSize = 10;
-
-    while (testSize < 2000) {
-        TTF_Font* testFont = TTF_OpenFont(FONT_PATH, testSize);
-
+    // Sizes are probed in steps of 10 from 100 up to 1990, and the largest step
+    // before the first one that overflows wins. Fit is monotonic in size, so
+    // bisect over the steps instead of opening the font up to ~190 times.
+    // A size the font fails to open at counts as not fitting.
+    bool openFailed = false;
+    auto fits = [&](int size) {
+        TTF_Font* testFont = TTF_OpenFont(FONT_PATH, size);
         if (!testFont) {
-            LOG_ERROR("Failed to load font %s at size %d: %s", FONT_PATH, testSize, TTF_GetError());
-            break;
+            LOG_ERROR("Failed to load font %s at size %d: %s", FONT_PATH, size, TTF_GetError());
+            openFailed = true;
+            return false;
         }
 
         int textWidth = 0, textHeight = 0;
         TTF_SizeText(testFont, testText, &textWidth, &textHeight);
         TTF_CloseFont(testFont);
+        return textHeight < targetHeight && textWidth < maxWidth;
+    };
+
+    const int minStep = 10;    // Size 100
+    const int maxStep = 199;   // Size 1990
+    int probes = 0;
+
+    if (!fits(minStep * 10)) {
+        // An unusable font gets the smallest size, as the linear search did
+        const int finalSize = openFailed ? 10 : minStep * 10 - 10;
+        LOG_DEBUG("Final large font size%s: %d", openFailed ? " (fallback)" : "", finalSize);
+        return finalSize;
+    }
 
-        if (textHeight >= targetHeight || textWidth >= maxWidth) {
-            int finalSize = std::max(10, testSize - 10);
-            LOG_DEBUG("Final large font size: %d", finalSize);
-            return finalSize;
+    // Invariant: lo fits, hi does not (hi == maxStep + 1 means "nothing failed")
+    int lo = minStep;
+    int hi = maxStep + 1;
+    while (hi - lo > 1) {
+        int mid = lo + (hi - lo) / 2;
+        ++probes;
+        if (fits(mid * 10)) {
+            lo = mid;
+        } else {
+            hi = mid;
         }
+    }
+
+    int finalSize = std::max(10, lo * 10);
+    LOG_DEBUG("Final large font size: %d (%d probes)", finalSize, probes + 1);
+    return finalSize;
+}
 
-        lastGoodSize = testSize;
-        testSize += 10;
+int Display::getLineSkip(FontSize size) const {
+    switch (size) {
+        case FontSize::LARGE: return metrics.largeLineSkip;
+        case FontSize::SMALL: return metrics.smallLineSkip;
+        case FontSize::EXTRA_SMALL: return metrics.extraSmallLineSkip;
+        default: return metrics.smallLineSkip;
     }
+}
 
-    LOG_DEBUG("Final large font size (fallback): %d", lastGoodSize);
-    return lastGoodSize;
+int Display::getMultilineTop(FontSize size, bool shadowed) const {
+    TTF_Font* font = getFont(size);
+    const int height = font ? TTF_FontHeight(font) : getLineSkip(size);
+    // Same placement as getOrCreateLayout() gives line 0
+    return textureRect(0, -height / 2, 0, height, shadowed).y;
 }
 
 TTF_Font* Display::getFont(FontSize size) const {
@@ -105,7 +196,7 @@ std::size_t Display::CacheKeyHash::operator()(const CacheKey& k) const {
     std::size_t seed = 0;
     
     // Hash text
-    seed ^= std::hash<std::string>{}(k.text) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<std::string_view>{}(k.text) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
     
     // Hash font size
     seed ^= std::hash<int>{}(static_cast<int>(k.fontSize)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
@@ -113,115 +204,181 @@ std::size_t Display::CacheKeyHash::operator()(const CacheKey& k) const {
     // Hash color as a single value
     Uint32 colorValue = (k.color.r << 24) | (k.color.g << 16) | (k.color.b << 8) | k.color.a;
     seed ^= std::hash<Uint32>{}(colorValue) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+
+    seed ^= std::hash<bool>{}(k.shadowed) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
     
     return seed;
 }
 
-SDL_Texture* Display::createTextTexture(const std::string& text, TTF_Font* font, 
-                                        SDL_Color color, int& outWidth, int& outHeight) {
+TextShadowParams Display::shadowParams() {
+    return TextShadowParams{SHADOW_OFFSET, SHADOW_RADIUS, SHADOW_SAMPLES, SHADOW_ALPHA};
+}
+
+SDL_Rect Display::textureRect(int x, int y, int width, int height, bool shadowed) {
+    if (!shadowed) {
+        return SDL_Rect{x, y, width, height};
+    }
+    const TextShadowParams params = shadowParams();
+    const int pad = params.padding();
+    const int extent = pad * 2 + params.offset;
+    return SDL_Rect{x - pad, y - pad, width + extent, height + extent};
+}
+
+SDL_Texture* Display::createTextTexture(const std::string& text, TTF_Font* font, SDL_Color color,
+                                        bool withShadow, int& outWidth, int& outHeight) {
     SDL_Surface* surface = TTF_RenderUTF8_Blended(font, text.c_str(), color);
     if (!surface) {
         LOG_ERROR("TTF_RenderUTF8_Blended failed: %s", TTF_GetError());
         return nullptr;
     }
+    outWidth = surface->w;
+    outHeight = surface->h;
+
+    // Blur and composite the shadow once here instead of drawing the text twice per frame
+    if (withShadow) {
+        SDL_Surface* shadowed = bakeTextShadow(surface, shadowParams());
+        SDL_FreeSurface(surface);
+        if (!shadowed) {
+            LOG_ERROR("Failed to bake text shadow: %s", SDL_GetError());
+            return nullptr;
+        }
+        surface = shadowed;
+    }
 
     SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
     if (!texture) {
         LOG_ERROR("SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
-        SDL_FreeSurface(surface);
         return nullptr;
     }
-
-    outWidth = surface->w;
-    outHeight = surface->h;
-    SDL_FreeSurface(surface);
     
     SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
     return texture;
 }
 
 SDL_Texture* Display::getOrCreateTexture(const std::string& text, FontSize size, SDL_Color color,
-                                        int* outWidth, int* outHeight) {
-    CacheKey key{text, size, color};
+                                        bool withShadow, int* outWidth, int* outHeight) {
+    CacheKey key{text, size, color, withShadow};
     
     // Check cache
     auto it = textureCache.find(key);
     if (it != textureCache.end()) {
-        it->second.lastUsed = std::chrono::steady_clock::now();
-        if (outWidth) *outWidth = it->second.width;
-        if (outHeight) *outHeight = it->second.height;
-        return it->second.texture.get();
+        CacheList::iterator entry = it->second;
+        entry->lastUsed = std::chrono::steady_clock::now();
+        lruList.splice(lruList.begin(), lruList, entry); // Move to front, O(1)
+        cacheStats.hits++;
+        if (outWidth) *outWidth = entry->width;
+        if (outHeight) *outHeight = entry->height;
+        return entry->texture.get();
     }
+    cacheStats.misses++;
 
     // Create new texture
     TTF_Font* font = getFont(size);
     if (!font) return nullptr;
 
     int width, height;
-    SDL_Texture* rawTexture = createTextTexture(text, font, color, width, height);
+    SDL_Texture* rawTexture = createTextTexture(text, font, color, withShadow, width, height);
     if (!rawTexture) return nullptr;
 
     // Estimate memory usage (RGBA8888 = 4 bytes per pixel)
-    size_t memorySize = width * height * 4;
+    const SDL_Rect extent = textureRect(0, 0, width, height, withShadow);
+    size_t memorySize = static_cast<size_t>(extent.w) * extent.h * 4;
 
-    // Evict old entries if needed
-    while (currentCacheMemory + memorySize > MAX_CACHE_MEMORY && !textureCache.empty()) {
+    // Evict least recently used entries if needed
+    const size_t budget = cacheBudget();
+    while (currentCacheMemory + memorySize > budget && !lruList.empty()) {
         removeOldestCacheEntry();
     }
 
     // Add to cache
     currentCacheMemory += memorySize;
-    auto result = textureCache.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(key),
-        std::forward_as_tuple(rawTexture, width, height, memorySize)
-    );
+    textureCharge.resize(currentCacheMemory);
+    lruList.emplace_front(text, size, color, withShadow, rawTexture, width, height, memorySize);
+    textureCache.emplace(lruList.front().key(), lruList.begin());
 
     if (outWidth) *outWidth = width;
     if (outHeight) *outHeight = height;
-    return result.first->second.texture.get();
+    return lruList.front().texture.get();
+}
+
+void Display::eraseCacheEntry(CacheList::iterator it) {
+    currentCacheMemory -= it->memorySize;
+    textureCharge.resize(currentCacheMemory);
+    textureCache.erase(it->key());
+    lruList.erase(it);
 }
 
 void Display::removeOldestCacheEntry() {
-    if (textureCache.empty()) return;
+    if (lruList.empty()) return;
 
-    auto oldest = textureCache.begin();
-    for (auto it = textureCache.begin(); it != textureCache.end(); ++it) {
-        if (it->second.lastUsed < oldest->second.lastUsed) {
-            oldest = it;
-        }
+    eraseCacheEntry(std::prev(lruList.end()));
+    cacheStats.evictions++;
+}
+
+void Display::renderTextWithAtlas(const GlyphAtlas& atlas, const std::string& text,
+                                   const TextStyle& style, int x, int y) {
+    int width = atlas.measureWidth(text);
+    int height = atlas.getLineHeight();
+
+    int posX = x;
+    switch (style.alignment) {
+        case TextAlign::CENTER:
+            posX = x - width / 2;
+            break;
+        case TextAlign::RIGHT:
+            posX = x - width;
+            break;
+        case TextAlign::LEFT:
+        default:
+            break;
     }
+    int posY = y - height / 2;
 
-    currentCacheMemory -= oldest->second.memorySize;
-    textureCache.erase(oldest);
-}
+    const SDL_Color shadowColor = {0, 0, 0, SHADOW_ALPHA};
 
-void Display::renderTextureWithShadow(SDL_Texture* texture, const SDL_Rect& rect, 
-                                      SDL_Color color, bool withShadow) {
-    if (withShadow) {
-        // Render shadow
-        SDL_Rect shadowRect = {
-            rect.x + SHADOW_OFFSET,
-            rect.y + SHADOW_OFFSET,
-            rect.w,
-            rect.h
-        };
-        
-        SDL_SetTextureColorMod(texture, 0, 0, 0);
-        SDL_SetTextureAlphaMod(texture, SHADOW_ALPHA);
-        SDL_RenderCopy(renderer, texture, nullptr, &shadowRect);
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (!glyphGeometryFailed) {
+        // Shadow and text share the atlas, so both go out in one draw call
+        glyphVertices.clear();
+        glyphIndices.clear();
+        if (style.withShadow) {
+            atlas.appendQuads(text, posX + SHADOW_OFFSET, posY + SHADOW_OFFSET, shadowColor,
+                              glyphVertices, glyphIndices);
+        }
+        atlas.appendQuads(text, posX, posY, style.color, glyphVertices, glyphIndices);
+
+        if (glyphIndices.empty()) {
+            return;
+        }
+        if (SDL_RenderGeometry(renderer, atlas.getTexture(),
+                               glyphVertices.data(), static_cast<int>(glyphVertices.size()),
+                               glyphIndices.data(), static_cast<int>(glyphIndices.size())) == 0) {
+            return;
+        }
+        LOG_WARNING("SDL_RenderGeometry failed for text (%s), drawing glyphs individually", SDL_GetError());
+        glyphGeometryFailed = true;
     }
+#endif
 
-    // Render main text
-    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
-    SDL_SetTextureAlphaMod(texture, color.a);
-    SDL_RenderCopy(renderer, texture, nullptr, &rect);
+    if (style.withShadow) {
+        atlas.drawDirect(renderer, text, posX + SHADOW_OFFSET, posY + SHADOW_OFFSET, shadowColor);
+    }
+    atlas.drawDirect(renderer, text, posX, posY, style.color);
 }
 
 void Display::renderText(const std::string& text, FontSize size, const TextStyle& style, 
                         int x, int y) {
+    if (textRenderMode == TextRenderMode::GLYPH_ATLAS && !style.staticText) {
+        const GlyphAtlas* atlas = getAtlas(size);
+        if (atlas && atlas->covers(text)) {
+            renderTextWithAtlas(*atlas, text, style, x, y);
+            return;
+        }
+    }
+
     int width, height;
-    SDL_Texture* texture = getOrCreateTexture(text, size, style.color, &width, &height);
+    SDL_Texture* texture = getOrCreateTexture(text, size, style.color, style.withShadow, &width, &height);
     if (!texture) return;
 
     // Calculate position based on alignment
@@ -241,33 +398,47 @@ void Display::renderText(const std::string& text, FontSize size, const TextStyle
     // Always center vertically (like the original code)
     int posY = y - height / 2;
 
-    SDL_Rect destRect = {posX, posY, width, height};
-    renderTextureWithShadow(texture, destRect, style.color, style.withShadow);
+    SDL_Rect destRect = textureRect(posX, posY, width, height, style.withShadow);
+    SDL_RenderCopy(renderer, texture, nullptr, &destRect);
 }
 
 std::vector<std::string> Display::wrapText(const std::string& text, TTF_Font* font, int maxWidth) {
     std::vector<std::string> lines;
-    std::istringstream stream(text);
-    std::string word, currentLine;
-
-    while (stream >> word) {
-        std::string testLine = currentLine.empty() ? word : currentLine + " " + word;
+    std::string currentLine;
+    std::string testLine;   // Reused measuring buffer (TTF needs NUL-terminated input)
+
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+
+    const std::string_view view(text);
+    size_t pos = 0;
+    while (pos < view.size()) {
+        // Next whitespace-separated word
+        while (pos < view.size() && isSpace(view[pos])) ++pos;
+        size_t end = pos;
+        while (end < view.size() && !isSpace(view[end])) ++end;
+        if (end == pos) break;
+        const std::string_view word = view.substr(pos, end - pos);
+        pos = end;
+
+        testLine.assign(currentLine);
+        if (!testLine.empty()) testLine += ' ';
+        testLine.append(word);
         
         int textWidth = 0;
         TTF_SizeUTF8(font, testLine.c_str(), &textWidth, nullptr);
         
         if (textWidth <= maxWidth) {
-            currentLine = testLine;
+            currentLine.swap(testLine);
         } else {
             if (!currentLine.empty()) {
                 lines.push_back(currentLine);
             }
-            currentLine = word;
+            currentLine.assign(word);
             
             // Handle words longer than max width
-            TTF_SizeUTF8(font, word.c_str(), &textWidth, nullptr);
+            TTF_SizeUTF8(font, currentLine.c_str(), &textWidth, nullptr);
             if (textWidth > maxWidth) {
-                lines.push_back(word);
+                lines.push_back(currentLine);
                 currentLine.clear();
             }
         }
@@ -280,22 +451,85 @@ std::vector<std::string> Display::wrapText(const std::string& text, TTF_Font* fo
     return lines;
 }
 
-void Display::renderMultilineText(const std::string& text, FontSize size, const TextStyle& style,
-                                  int x, int y, int maxWidth) {
+const Display::TextLayout* Display::getOrCreateLayout(const std::string& text, FontSize size,
+                                                      const TextStyle& style, int maxWidth) {
+    const std::size_t hash = std::hash<std::string_view>{}(text);
+
+    for (auto it = layoutCache.begin(); it != layoutCache.end(); ++it) {
+        if (it->matches(text, hash, size, maxWidth, style.color, style.alignment, style.withShadow)) {
+            it->lastUsed = std::chrono::steady_clock::now();
+            if (it != layoutCache.begin()) {
+                layoutCache.splice(layoutCache.begin(), layoutCache, it);
+            }
+            return &layoutCache.front();
+        }
+    }
+
+    // Miss: wrap and rasterize every line once
     TTF_Font* font = getFont(size);
-    if (!font) return;
+    if (!font) return nullptr;
+
+    if (layoutCache.size() >= MAX_CACHED_LAYOUTS) {
+        layoutCacheMemory -= layoutCache.back().memorySize;
+        layoutCache.pop_back();
+        layoutCharge.resize(layoutCacheMemory);
+    }
+
+    layoutCache.emplace_front();
+    TextLayout& layout = layoutCache.front();
+    layout.text = text;
+    layout.textHash = hash;
+    layout.fontSize = size;
+    layout.maxWidth = maxWidth;
+    layout.color = style.color;
+    layout.alignment = style.alignment;
+    layout.shadowed = style.withShadow;
+    layout.lastUsed = std::chrono::steady_clock::now();
+
+    std::vector<std::string> lines = wrapText(text, font, maxWidth);
+    const int lineHeight = TTF_FontLineSkip(font);
+    layout.lines.reserve(lines.size());
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        int width, height;
+        SDL_Texture* texture = createTextTexture(lines[i], font, style.color, style.withShadow, width, height);
+        if (!texture) continue;
+
+        // Same placement as renderText(): aligned horizontally, centred on the line
+        int offsetX = 0;
+        switch (style.alignment) {
+            case TextAlign::CENTER: offsetX = -width / 2; break;
+            case TextAlign::RIGHT:  offsetX = -width; break;
+            case TextAlign::LEFT:
+            default: break;
+        }
+        int offsetY = static_cast<int>(i) * lineHeight - height / 2;
+
+        const SDL_Rect rect = textureRect(offsetX, offsetY, width, height, style.withShadow);
+        layout.lines.emplace_back(texture, rect);
+        layout.memorySize += static_cast<size_t>(rect.w) * rect.h * 4;
+    }
+    layoutCacheMemory += layout.memorySize;
+    layoutCharge.resize(layoutCacheMemory);
 
+    LOG_DEBUG("Laid out %d lines of multiline text (%zu KB)", static_cast<int>(layout.lines.size()),
+              layout.memorySize / 1024);
+    return &layout;
+}
+
+void Display::renderMultilineText(const std::string& text, FontSize size, const TextStyle& style,
+                                  int x, int y, int maxWidth) {
     // Use 90% of screen width if no max width specified
     if (maxWidth == 0) {
         maxWidth = static_cast<int>(screenWidth * 0.9);
     }
 
-    std::vector<std::string> lines = wrapText(text, font, maxWidth);
-    int lineHeight = TTF_FontLineSkip(font);
+    const TextLayout* layout = getOrCreateLayout(text, size, style, maxWidth);
+    if (!layout) return;
 
-    for (size_t i = 0; i < lines.size(); ++i) {
-        int lineY = y + static_cast<int>(i) * lineHeight;
-        renderText(lines[i], size, style, x, lineY);
+    for (const auto& line : layout->lines) {
+        SDL_Rect destRect = {x + line.rect.x, y + line.rect.y, line.rect.w, line.rect.h};
+        SDL_RenderCopy(renderer, line.texture.get(), nullptr, &destRect);
     }
 }
 
@@ -337,22 +571,84 @@ void Display::cleanupCache() {
     
     lastCacheCleanup = now;
     
-    // Use iterator directly for efficient removal
-    for (auto it = textureCache.begin(); it != textureCache.end(); ) {
+    // Expired entries are all at the back of the LRU list
+    while (!lruList.empty()) {
         auto age = std::chrono::duration_cast<std::chrono::seconds>(
-            now - it->second.lastUsed
+            now - lruList.back().lastUsed
         );
         
-        if (age.count() > CACHE_LIFETIME_SECONDS) {
-            currentCacheMemory -= it->second.memorySize;
-            it = textureCache.erase(it);  // Erase returns next valid iterator
-        } else {
-            ++it;  // Only increment if we didn't erase
+        if (age.count() <= cacheLifetimeSeconds) {
+            break;
         }
+        eraseCacheEntry(std::prev(lruList.end()));
+        cacheStats.expirations++;
+    }
+
+    // Give memory back when other subsystems have grown into the global budget
+    const size_t budget = cacheBudget();
+    while (currentCacheMemory > budget && !lruList.empty()) {
+        removeOldestCacheEntry();
+    }
+
+    // Same lifetime for layouts
+    while (!layoutCache.empty()) {
+        auto age = std::chrono::duration_cast<std::chrono::seconds>(
+            now - layoutCache.back().lastUsed
+        );
+        if (age.count() <= cacheLifetimeSeconds) {
+            break;
+        }
+        layoutCacheMemory -= layoutCache.back().memorySize;
+        layoutCache.pop_back();
+        layoutCharge.resize(layoutCacheMemory);
     }
 }
 
 void Display::clearCache() {
     textureCache.clear();
+    lruList.clear();
     currentCacheMemory = 0;
+    textureCharge.release();
+    layoutCache.clear();
+    layoutCacheMemory = 0;
+    layoutCharge.release();
+}
+
+void Display::recreateTextures() {
+    clearCache();
+    buildGlyphAtlases();
+}
+
+void Display::setCacheBudget(size_t maxBytes) {
+    maxCacheMemory = maxBytes;
+    const size_t budget = cacheBudget();
+    while (currentCacheMemory > budget && !lruList.empty()) {
+        removeOldestCacheEntry();
+    }
+    LOG_INFO("Text cache budget set to %zu KB", maxBytes / 1024);
+}
+
+size_t Display::cacheBudget() const {
+    // What the global budget leaves for string textures once everything else,
+    // atlases and layouts included, is counted
+    const MemoryBudget& budget = MemoryBudget::instance();
+    const size_t pool = budget.usage(MemoryPool::TEXT_CACHE);
+    const size_t otherText = pool > textureCharge.bytes() ? pool - textureCharge.bytes() : 0;
+    const size_t available = budget.availableFor(MemoryPool::TEXT_CACHE);
+    const size_t allowed = available > otherText ? available - otherText : 0;
+    return std::min(maxCacheMemory, std::max(allowed, TEXT_CACHE_MIN_BYTES));
+}
+
+void Display::setCacheLifetime(int seconds) {
+    cacheLifetimeSeconds = std::max(0, seconds);
+}
+
+TextCacheStats Display::getCacheStats() const {
+    TextCacheStats stats = cacheStats;
+    stats.residentBytes = currentCacheMemory;
+    stats.entries = lruList.size();
+    stats.budgetBytes = cacheBudget();
+    stats.layouts = layoutCache.size();
+    stats.layoutBytes = layoutCacheMemory;
+    return stats;
 }
\ No newline at end of file
@@ -5,9 +5,15 @@
 #include <SDL2/SDL_ttf.h>
 #include <string>
 #include <unordered_map>
+#include <list>
+#include <string_view>
 #include <memory>
 #include <chrono>
 #include <vector>  // <-- ADD THIS
+#include "glyph_atlas.h"
+#include "font_metrics_cache.h"
+#include "text_shadow.h"
+#include "memory_budget.h"
 
 // Text alignment options
 enum class TextAlign {
@@ -21,6 +27,13 @@ struct TextStyle {
     SDL_Color color = {255, 255, 255, 255};
     bool withShadow = true;
     TextAlign alignment = TextAlign::CENTER;
+    bool staticText = false;   // Long text that rarely changes: keep as one cached texture
+};
+
+// How renderText() turns strings into pixels
+enum class TextRenderMode {
+    STRING_TEXTURES,   // Rasterize and cache one texture per string
+    GLYPH_ATLAS        // Draw from pre-rasterized glyphs (falls back per string if a glyph is missing)
 };
 
 // Font size categories
@@ -30,6 +43,19 @@ enum class FontSize {
     LARGE
 };
 
+// Text texture cache counters, for sizing the cache per device
+struct TextCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;     // Removed to stay within the byte budget
+    uint64_t expirations = 0;   // Removed after going unused for the lifetime
+    size_t residentBytes = 0;
+    size_t entries = 0;
+    size_t budgetBytes = 0;
+    size_t layouts = 0;         // Cached multi-line layouts
+    size_t layoutBytes = 0;
+};
+
 class Display {
 public:
     Display(SDL_Renderer* renderer, int screenWidth, int screenHeight);
@@ -40,6 +66,10 @@ public:
     void renderMultilineText(const std::string& text, FontSize size, const TextStyle& style, 
                             int x, int y, int maxWidth = 0);
 
+    // Text rendering mode (glyph atlas by default)
+    void setTextRenderMode(TextRenderMode mode) { textRenderMode = mode; }
+    TextRenderMode getTextRenderMode() const { return textRenderMode; }
+
     // FPS counter
     void updateFps();
     void renderFps();
@@ -48,30 +78,58 @@ public:
     // Cache management
     void cleanupCache();
     void clearCache();
+    void setCacheBudget(size_t maxBytes);          // Evicts immediately if over the new budget
+    void setCacheLifetime(int seconds);
+    TextCacheStats getCacheStats() const;
+
+    // After the renderer lost its textures: drops the cache, rebuilds the glyph atlases
+    void recreateTextures();
 
     // Get font for external size calculations if needed
     TTF_Font* getFont(FontSize size) const;
+    int getLineSkip(FontSize size) const;
+    // Top of the first line drawn by renderMultilineText(), relative to its y,
+    // shadow included (negative: the first line is centred on y)
+    int getMultilineTop(FontSize size, bool shadowed) const;
 
 private:
+    friend class DisplayBench; // bench/bench_display.cpp
+
     // Core resources
     SDL_Renderer* renderer;
     int screenWidth;
     int screenHeight;
 
     // Fonts
+    FontMetrics metrics;
     std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> fontLarge;
     std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> fontSmall;
     std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> fontExtraSmall;
 
-    // Text cache
+    // Glyph atlases, one per font size
+    TextRenderMode textRenderMode;
+    GlyphAtlas atlasLarge;
+    GlyphAtlas atlasSmall;
+    GlyphAtlas atlasExtraSmall;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    std::vector<SDL_Vertex> glyphVertices;   // Reused between calls
+    std::vector<int> glyphIndices;
+    bool glyphGeometryFailed = false;
+#endif
+
+    // Text cache: LRU list (front = most recently used) indexed by a hash map.
+    // Map keys view the strings owned by the list nodes, which never move, so
+    // lookups, touches and evictions are O(1) and a lookup never allocates.
     struct CacheKey {
-        std::string text;
+        std::string_view text;
         FontSize fontSize;
         SDL_Color color;
+        bool shadowed;
 
         bool operator==(const CacheKey& other) const {
             return text == other.text && 
                    fontSize == other.fontSize &&
+                   shadowed == other.shadowed &&
                    color.r == other.color.r &&
                    color.g == other.color.g &&
                    color.b == other.color.b &&
@@ -84,19 +142,69 @@ private:
     };
 
     struct CachedTexture {
+        std::string text;
+        FontSize fontSize;
+        SDL_Color color;
+        bool shadowed;      // Texture has the soft shadow baked in (see textureRect())
         std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture;
-        int width;
+        int width;          // Glyph box, without the shadow margin
         int height;
         std::chrono::steady_clock::time_point lastUsed;
         size_t memorySize;
 
-        CachedTexture(SDL_Texture* tex, int w, int h, size_t mem)
-            : texture(tex, SDL_DestroyTexture), width(w), height(h), 
+        CachedTexture(const std::string& text, FontSize size, SDL_Color color, bool shadowed,
+                      SDL_Texture* tex, int w, int h, size_t mem)
+            : text(text), fontSize(size), color(color), shadowed(shadowed),
+              texture(tex, SDL_DestroyTexture), width(w), height(h), 
               lastUsed(std::chrono::steady_clock::now()), memorySize(mem) {}
+
+        CacheKey key() const { return CacheKey{text, fontSize, color, shadowed}; }
     };
 
-    std::unordered_map<CacheKey, CachedTexture, CacheKeyHash> textureCache;
+    using CacheList = std::list<CachedTexture>;
+    CacheList lruList;
+    std::unordered_map<CacheKey, CacheList::iterator, CacheKeyHash> textureCache;
+
+    // Layout cache for renderMultilineText(): wrapped lines with their own
+    // textures and offsets from the anchor point, so a frame is just a list of
+    // copies. Only a handful of texts are on screen, so a short MRU list is enough.
+    struct TextLayout {
+        struct Line {
+            std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture;
+            SDL_Rect rect;   // Relative to the anchor point
+
+            Line(SDL_Texture* tex, const SDL_Rect& r) : texture(tex, SDL_DestroyTexture), rect(r) {}
+        };
+
+        std::string text;
+        std::size_t textHash;
+        FontSize fontSize;
+        int maxWidth;
+        SDL_Color color;
+        TextAlign alignment;
+        bool shadowed;
+        std::vector<Line> lines;
+        size_t memorySize = 0;
+        std::chrono::steady_clock::time_point lastUsed;
+
+        bool matches(std::string_view t, std::size_t hash, FontSize size, int width,
+                     SDL_Color c, TextAlign align, bool shadow) const {
+            return textHash == hash && fontSize == size && maxWidth == width &&
+                   alignment == align && shadowed == shadow && color.r == c.r && color.g == c.g &&
+                   color.b == c.b && color.a == c.a && text == t;
+        }
+    };
+
+    std::list<TextLayout> layoutCache;   // Front = most recently used
+    size_t layoutCacheMemory;
+    static constexpr size_t MAX_CACHED_LAYOUTS = 8;
     size_t currentCacheMemory;
+    size_t maxCacheMemory;
+    MemoryCharge textureCharge;   // currentCacheMemory, in MemoryPool::TEXT_CACHE
+    MemoryCharge layoutCharge;    // layoutCacheMemory
+    MemoryCharge atlasCharge;     // Glyph atlas textures
+    int cacheLifetimeSeconds;
+    TextCacheStats cacheStats;
 
     // FPS tracking
     float currentFps;
@@ -106,27 +214,32 @@ private:
     std::chrono::steady_clock::time_point lastCacheCleanup;
 
     // Configuration
-    static constexpr size_t MAX_CACHE_MEMORY = 50 * 1024 * 1024; // 50MB
-    static constexpr int CACHE_LIFETIME_SECONDS = 30;
     static constexpr int CACHE_CLEANUP_INTERVAL_SECONDS = 5;  // Cleanup every 5 seconds
     static constexpr int SHADOW_OFFSET = 2;
-    static constexpr Uint8 SHADOW_ALPHA = 128;
 
     // Helper methods
     TTF_Font* loadFont(const char* path, int size);
     int calculateLargeFontSize();
+    void buildGlyphAtlases();
+    size_t cacheBudget() const;   // maxCacheMemory, lowered to fit the global MemoryBudget
+    const GlyphAtlas* getAtlas(FontSize size) const;
+    void renderTextWithAtlas(const GlyphAtlas& atlas, const std::string& text, const TextStyle& style, int x, int y);
     
-    SDL_Texture* getOrCreateTexture(const std::string& text, FontSize size, SDL_Color color,
+    // outWidth/outHeight get the glyph box; draw the texture at textureRect()
+    SDL_Texture* getOrCreateTexture(const std::string& text, FontSize size, SDL_Color color, bool withShadow,
                                    int* outWidth = nullptr, int* outHeight = nullptr);
 
-    SDL_Texture* createTextTexture(const std::string& text, TTF_Font* font, SDL_Color color, 
+    SDL_Texture* createTextTexture(const std::string& text, TTF_Font* font, SDL_Color color, bool withShadow,
                                    int& outWidth, int& outHeight);
-    
-    void renderTextureWithShadow(SDL_Texture* texture, const SDL_Rect& rect, 
-                                 SDL_Color color, bool withShadow);
+
+    static TextShadowParams shadowParams();
+    // Where a text texture goes for a glyph box at (x, y); shadowed textures extend past it
+    static SDL_Rect textureRect(int x, int y, int width, int height, bool shadowed);
     
     std::vector<std::string> wrapText(const std::string& text, TTF_Font* font, int maxWidth);
+    const TextLayout* getOrCreateLayout(const std::string& text, FontSize size, const TextStyle& style, int maxWidth);
     void removeOldestCacheEntry();
+    void eraseCacheEntry(CacheList::iterator it);
 };
 
 #endif // DISPLAY_H
\ No newline at end of file
@@ -0,0 +1,59 @@
+// display_model.cpp
+#include "display_model.h"
+#include "config.h"
+#include "weather.h"
+#include "weather_api.h"
+#include <cstdio>
+
+DisplayModel::DisplayModel()
+    : minute(-1)
+    , weatherVersion(0)
+    , haveWeather(false)
+{
+}
+
+void DisplayModel::invalidate() {
+    minute = -1;
+    haveWeather = false;
+}
+
+bool DisplayModel::refresh(time_t now, const WeatherAPI& weather) {
+    bool changed = false;
+
+    // Local UTC offsets are whole minutes, so local minutes roll over with epoch minutes
+    if (now / 60 != minute) {
+        minute = now / 60;
+        formatTime(now);
+        changed = true;
+    }
+
+    const uint64_t version = weather.getDataVersion();
+    if (!haveWeather || version != weatherVersion) {
+        WeatherData data = weather.getWeather();
+        weatherLine = getWeatherDescription(data.temperature, data.weathercode, data.windspeed);
+        weatherVersion = version;
+        haveWeather = true;
+        changed = true;
+    }
+    return changed;
+}
+
+void DisplayModel::formatTime(time_t now) {
+    std::tm local;
+    localtime_r(&now, &local);
+
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%02d:%02d", local.tm_hour, local.tm_min);
+    timeLine.assign(buffer);
+
+    // e.g. "понедельник, 13 января 2025 года"
+    dateLine.assign(WEEKDAYS_RU.at(local.tm_wday));
+    dateLine.append(", ");
+    std::snprintf(buffer, sizeof(buffer), "%d", local.tm_mday);
+    dateLine.append(buffer);
+    dateLine.push_back(' ');
+    dateLine.append(MONTHS_RU.at(local.tm_mon + 1));
+    std::snprintf(buffer, sizeof(buffer), " %d", local.tm_year + 1900);
+    dateLine.append(buffer);
+    dateLine.append(" года");
+}
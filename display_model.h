@@ -0,0 +1,44 @@
+// display_model.h
+#ifndef DISPLAY_MODEL_H
+#define DISPLAY_MODEL_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+class WeatherAPI;
+
+// The text Clock::draw() puts on screen, formatted once per change instead of
+// once per frame: time and date when the wall-clock minute changes, the
+// weather line when WeatherAPI stores new data. refresh() on an unchanged
+// minute and weather version is two comparisons, with no time formatting and
+// no allocation; Display's caches are keyed by these strings, so the lookups
+// behind them hit as well.
+class DisplayModel {
+public:
+    DisplayModel();
+
+    // Rebuild whatever is stale. Returns true if any text changed.
+    bool refresh(time_t now, const WeatherAPI& weather);
+
+    // Force a rebuild on the next refresh()
+    void invalidate();
+
+    const std::string& timeText() const { return timeLine; }
+    const std::string& dateText() const { return dateLine; }
+    const std::string& weatherText() const { return weatherLine; }
+
+private:
+    time_t minute;             // now / 60 of the last time/date rebuild
+    uint64_t weatherVersion;   // WeatherAPI::getDataVersion() of the last weather rebuild
+    bool haveWeather;
+
+    // Assigned in place, so capacity is reused across rebuilds
+    std::string timeLine;
+    std::string dateLine;
+    std::string weatherLine;
+
+    void formatTime(time_t now);
+};
+
+#endif // DISPLAY_MODEL_H
@@ -0,0 +1,89 @@
+// font_metrics_cache.cpp
+#include "font_metrics_cache.h"
+#include "cache_file.h"
+#include "logger.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <cstdio>
+
+using json = nlohmann::json;
+
+namespace {
+
+std::string makeKey(uint64_t fontHash, int screenWidth, int screenHeight) {
+    char key[64];
+    std::snprintf(key, sizeof(key), "%016llx:%dx%d",
+                  static_cast<unsigned long long>(fontHash), screenWidth, screenHeight);
+    return key;
+}
+
+json readCache(const char* cachePath) {
+    std::ifstream in(cachePath);
+    if (!in.is_open()) {
+        return json::object();
+    }
+    json data = json::parse(in, nullptr, false);
+    return data.is_object() ? data : json::object();
+}
+
+} // namespace
+
+uint64_t hashFontFile(const char* path) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+
+    uint64_t hash = 1469598103934665603ULL;
+    unsigned char buffer[16384];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; i < read; ++i) {
+            hash ^= buffer[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    std::fclose(file);
+    return hash;
+}
+
+bool loadFontMetrics(const char* cachePath, uint64_t fontHash, int screenWidth, int screenHeight,
+                     FontMetrics& out) {
+    if (fontHash == 0) return false;
+
+    json data = readCache(cachePath);
+    auto it = data.find(makeKey(fontHash, screenWidth, screenHeight));
+    if (it == data.end() || !it->is_object()) {
+        return false;
+    }
+
+    try {
+        out.largeSize = it->at("large").get<int>();
+        out.smallSize = it->at("small").get<int>();
+        out.extraSmallSize = it->at("extraSmall").get<int>();
+        out.largeLineSkip = it->value("largeLineSkip", 0);
+        out.smallLineSkip = it->value("smallLineSkip", 0);
+        out.extraSmallLineSkip = it->value("extraSmallLineSkip", 0);
+    } catch (const std::exception& e) {
+        LOG_WARNING("Ignoring malformed font metrics cache entry: %s", e.what());
+        return false;
+    }
+    return out.largeSize > 0 && out.smallSize > 0 && out.extraSmallSize > 0;
+}
+
+bool saveFontMetrics(const char* cachePath, uint64_t fontHash, int screenWidth, int screenHeight,
+                     const FontMetrics& metrics) {
+    if (fontHash == 0) return false;
+
+    json data = readCache(cachePath);
+    data[makeKey(fontHash, screenWidth, screenHeight)] = {
+        {"large", metrics.largeSize},
+        {"small", metrics.smallSize},
+        {"extraSmall", metrics.extraSmallSize},
+        {"largeLineSkip", metrics.largeLineSkip},
+        {"smallLineSkip", metrics.smallLineSkip},
+        {"extraSmallLineSkip", metrics.extraSmallLineSkip}
+    };
+
+    return writeFileAtomically(cachePath, data.dump(2));
+}
@@ -0,0 +1,28 @@
+// font_metrics_cache.h
+#ifndef FONT_METRICS_CACHE_H
+#define FONT_METRICS_CACHE_H
+
+#include <string>
+#include <cstdint>
+
+// Font sizes resolved for one font file and screen resolution. Finding the
+// large size means opening the font repeatedly, so results are persisted.
+struct FontMetrics {
+    int largeSize = 0;
+    int smallSize = 0;
+    int extraSmallSize = 0;
+    int largeLineSkip = 0;
+    int smallLineSkip = 0;
+    int extraSmallLineSkip = 0;
+};
+
+// FNV-1a hash of the file contents (0 if unreadable)
+uint64_t hashFontFile(const char* path);
+
+// Look up / store metrics keyed by font hash and resolution
+bool loadFontMetrics(const char* cachePath, uint64_t fontHash, int screenWidth, int screenHeight,
+                     FontMetrics& out);
+bool saveFontMetrics(const char* cachePath, uint64_t fontHash, int screenWidth, int screenHeight,
+                     const FontMetrics& metrics);
+
+#endif // FONT_METRICS_CACHE_H
@@ -0,0 +1,152 @@
+// frame_profiler.cpp
+#include "frame_profiler.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstring>
+
+constexpr size_t DurationHistogram::SUB_BUCKETS;
+constexpr size_t DurationHistogram::BUCKETS;
+
+DurationHistogram::DurationHistogram() : total(0), sum(0), max(0) {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t DurationHistogram::bucketFor(uint32_t micros) {
+    if (micros < SUB_BUCKETS) {
+        return micros; // Exact below 8 us
+    }
+    int octave = 31 - __builtin_clz(micros); // >= 3
+    size_t sub = (micros >> (octave - 3)) & (SUB_BUCKETS - 1);
+    size_t index = SUB_BUCKETS + static_cast<size_t>(octave - 3) * SUB_BUCKETS + sub;
+    return std::min(index, BUCKETS - 1);
+}
+
+uint32_t DurationHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return static_cast<uint32_t>(index);
+    }
+    size_t octave = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    size_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return static_cast<uint32_t>(((SUB_BUCKETS + sub + 1) << octave) - 1);
+}
+
+void DurationHistogram::record(uint32_t micros) {
+    // Single writer: plain load/store instead of locked read-modify-write
+    auto& bucket = buckets[bucketFor(micros)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + micros, std::memory_order_relaxed);
+    if (micros > max.load(std::memory_order_relaxed)) {
+        max.store(micros, std::memory_order_relaxed);
+    }
+}
+
+uint32_t DurationHistogram::percentile(double q) const {
+    uint32_t counts[BUCKETS];
+    uint64_t samples = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        counts[b] = bucketCount(b);
+        samples += counts[b];
+    }
+    return percentileOf(counts, samples, q, maxMicros());
+}
+
+uint32_t DurationHistogram::percentileOf(const uint32_t* counts, uint64_t samples, double q, uint32_t maxMicros) {
+    if (samples == 0) {
+        return 0;
+    }
+    // Reported as the bucket's upper bound, so never below the true value
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * samples + 0.999999));
+    uint64_t seen = 0;
+    size_t b = 0;
+    for (; b < BUCKETS - 1; ++b) {
+        seen += counts[b];
+        if (seen >= rank) break;
+    }
+    return std::min(bucketUpperBound(b), maxMicros);
+}
+
+FrameProfiler::FrameProfiler(int refreshRate)
+    : missed(0)
+    , missedReported(0)
+    , vsyncPeriod(std::chrono::microseconds(1000000 / std::max(refreshRate, 1)))
+    , havePreviousFrame(false)
+    , lastReport(std::chrono::steady_clock::now())
+{
+    std::memset(lastReported, 0, sizeof(lastReported));
+    std::memset(windowMax, 0, sizeof(windowMax));
+}
+
+void FrameProfiler::record(FramePhase phase, std::chrono::steady_clock::duration elapsed) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    uint32_t value = static_cast<uint32_t>(std::clamp<long long>(micros, 0, UINT32_MAX));
+    size_t index = static_cast<size_t>(phase);
+    phases[index].record(value);
+    windowMax[index] = std::max(windowMax[index], value);
+}
+
+void FrameProfiler::beginFrame(bool vsyncPaced) {
+    auto now = std::chrono::steady_clock::now();
+    if (vsyncPaced && havePreviousFrame) {
+        // A gap of n periods means n - 1 refreshes went by without a new frame
+        auto periods = (now - lastFrameStart + vsyncPeriod / 2) / vsyncPeriod;
+        if (periods > 1) {
+            missed.store(missed.load(std::memory_order_relaxed) + static_cast<uint64_t>(periods - 1),
+                         std::memory_order_relaxed);
+        }
+    }
+    havePreviousFrame = vsyncPaced;
+    lastFrameStart = now;
+}
+
+void FrameProfiler::logReport() {
+    auto now = std::chrono::steady_clock::now();
+    long long windowSeconds = std::chrono::duration_cast<std::chrono::seconds>(now - lastReport).count();
+    lastReport = now;
+
+    uint32_t window[DurationHistogram::BUCKETS];
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        const DurationHistogram& hist = phases[p];
+        uint64_t samples = 0;
+        for (size_t b = 0; b < DurationHistogram::BUCKETS; ++b) {
+            uint32_t current = hist.bucketCount(b);
+            window[b] = current - lastReported[p][b]; // Wraps correctly
+            lastReported[p][b] = current;
+            samples += window[b];
+        }
+        if (samples == 0) {
+            continue;
+        }
+
+        auto percentile = [&](double q) {
+            return DurationHistogram::percentileOf(window, samples, q, windowMax[p]) / 1000.0;
+        };
+
+        LOG_INFO("Frame phase %-11s (%llu samples): p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms",
+                 phaseName(static_cast<FramePhase>(p)), static_cast<unsigned long long>(samples),
+                 percentile(0.50), percentile(0.95), percentile(0.99), windowMax[p] / 1000.0);
+        windowMax[p] = 0;
+    }
+
+    uint64_t missedNow = missed.load(std::memory_order_relaxed);
+    LOG_INFO("Missed vsyncs: %llu in the last %lld s (%llu total)",
+             static_cast<unsigned long long>(missedNow - missedReported), windowSeconds,
+             static_cast<unsigned long long>(missedNow));
+    missedReported = missedNow;
+}
+
+const char* FrameProfiler::phaseName(FramePhase phase) {
+    switch (phase) {
+        case FramePhase::EVENTS:      return "events";
+        case FramePhase::UPDATE:      return "update";
+        case FramePhase::SNOW_UPDATE: return "snow_update";
+        case FramePhase::BACKGROUND:  return "background";
+        case FramePhase::SNOW_DRAW:   return "snow_draw";
+        case FramePhase::TEXT:        return "text";
+        case FramePhase::PRESENT:     return "present";
+        case FramePhase::FRAME:       return "frame";
+        default:                      return "unknown";
+    }
+}
@@ -0,0 +1,122 @@
+// frame_profiler.h
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Frame phases timed by the main loop. FRAME covers update() and draw() together.
+enum class FramePhase {
+    EVENTS,
+    UPDATE,
+    SNOW_UPDATE,
+    BACKGROUND,
+    SNOW_DRAW,
+    TEXT,
+    PRESENT,
+    FRAME,
+    COUNT
+};
+
+// Durations in log-linear microsecond buckets (8 per power of two, ~9%
+// resolution, up to ~4 s). Fixed arrays, so recording never allocates.
+// Written only by the render thread; counts are relaxed atomics so other
+// threads can read a cumulative snapshot without taking a lock.
+class DurationHistogram {
+public:
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t BUCKETS = SUB_BUCKETS + 19 * SUB_BUCKETS;
+
+    DurationHistogram();
+
+    void record(uint32_t micros);
+
+    // Cumulative since start
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t sumMicros() const { return sum.load(std::memory_order_relaxed); }
+    uint32_t bucketCount(size_t index) const { return buckets[index].load(std::memory_order_relaxed); }
+    uint32_t maxMicros() const { return max.load(std::memory_order_relaxed); }
+
+    // Cumulative nearest-rank percentile (q in 0..1) in microseconds
+    uint32_t percentile(double q) const;
+
+    // Largest duration a sample in bucket index can have
+    static uint32_t bucketUpperBound(size_t index);
+
+    // Percentile over a copy of the bucket counts, capped at maxMicros
+    static uint32_t percentileOf(const uint32_t* counts, uint64_t samples, double q, uint32_t maxMicros);
+
+private:
+    std::atomic<uint32_t> buckets[BUCKETS];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint32_t> max;
+
+    static size_t bucketFor(uint32_t micros);
+};
+
+class FrameProfiler {
+public:
+    // refreshRate (Hz) sets the vsync period used to count missed vsyncs
+    explicit FrameProfiler(int refreshRate);
+
+    void record(FramePhase phase, std::chrono::steady_clock::duration elapsed);
+
+    // Call at the start of each produced frame. In vsync-paced mode a gap of
+    // more than one refresh period since the previous frame counts as missed vsyncs.
+    void beginFrame(bool vsyncPaced);
+
+    // Logs p50/p95/p99/max per phase for the frames since the previous report
+    void logReport();
+
+    const DurationHistogram& histogram(FramePhase phase) const { return phases[static_cast<size_t>(phase)]; }
+    uint64_t missedVsyncs() const { return missed.load(std::memory_order_relaxed); }
+    uint64_t frames() const { return histogram(FramePhase::FRAME).count(); }
+
+    static const char* phaseName(FramePhase phase);
+
+private:
+    static constexpr size_t PHASE_COUNT = static_cast<size_t>(FramePhase::COUNT);
+
+    DurationHistogram phases[PHASE_COUNT];
+    std::atomic<uint64_t> missed;
+
+    // Render-thread state for windowed reports
+    uint32_t lastReported[PHASE_COUNT][DurationHistogram::BUCKETS];
+    uint32_t windowMax[PHASE_COUNT];
+    uint64_t missedReported;
+    std::chrono::steady_clock::duration vsyncPeriod;
+    std::chrono::steady_clock::time_point lastFrameStart;
+    bool havePreviousFrame;
+    std::chrono::steady_clock::time_point lastReport;
+};
+
+// Times the enclosing scope into profiler (does nothing when profiler is null)
+class ScopedPhase {
+public:
+    ScopedPhase(FrameProfiler* profiler, FramePhase phase)
+        : profiler(profiler), phase(phase)
+    {
+        if (profiler) start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedPhase() { stop(); }
+
+    // Record now instead of at the end of the scope
+    void stop() {
+        if (profiler) profiler->record(phase, std::chrono::steady_clock::now() - start);
+        profiler = nullptr;
+    }
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    FrameProfiler* profiler;
+    FramePhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // FRAME_PROFILER_H
@@ -0,0 +1,104 @@
+// frame_scheduler.cpp
+#include "frame_scheduler.h"
+#include "logger.h"
+#include <algorithm>
+
+std::atomic<Uint32> FrameScheduler::wakeEventType{static_cast<Uint32>(-1)};
+
+FrameScheduler::FrameScheduler(FrameMode mode, int cappedFps)
+    : mode(mode)
+    , frameInterval(0)
+    , lastFrameStart(Clock::now())
+    , lastDrawnMinute(0)
+    , redrawRequested(true)
+{
+    Uint32 type = SDL_RegisterEvents(1);
+    if (type == static_cast<Uint32>(-1)) {
+        LOG_WARNING("SDL_RegisterEvents failed, worker wake-ups disabled");
+    }
+    wakeEventType.store(type);
+    setMode(mode, cappedFps);
+}
+
+void FrameScheduler::setMode(FrameMode newMode, int cappedFps) {
+    mode = newMode;
+    cappedFps = std::clamp(cappedFps, 1, 240);
+    frameInterval = std::chrono::microseconds(1000000 / cappedFps);
+    redrawRequested = true;
+
+    switch (mode) {
+        case FrameMode::FULL_RATE: LOG_INFO("Frame scheduler: full rate (vsync)"); break;
+        case FrameMode::CAPPED:    LOG_INFO("Frame scheduler: capped at %d FPS", cappedFps); break;
+        case FrameMode::IDLE:      LOG_INFO("Frame scheduler: idle (redraw on change only)"); break;
+    }
+}
+
+void FrameScheduler::requestWake() {
+    Uint32 type = wakeEventType.load();
+    if (type == static_cast<Uint32>(-1)) return;
+
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = type;
+    SDL_PushEvent(&event); // SDL_PushEvent is thread-safe
+}
+
+bool FrameScheduler::isWakeEvent(const SDL_Event& event) {
+    Uint32 type = wakeEventType.load();
+    return type != static_cast<Uint32>(-1) && event.type == type;
+}
+
+FrameScheduler::Clock::time_point FrameScheduler::nextDeadline() const {
+    auto now = Clock::now();
+    switch (mode) {
+        case FrameMode::CAPPED:
+            return lastFrameStart + frameInterval;
+        case FrameMode::IDLE: {
+            // Wake at the next wall-clock minute so the time display changes on time
+            auto sinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+            auto toNextMinute = std::chrono::milliseconds(60000 - sinceEpoch.count() % 60000);
+            return now + toNextMinute;
+        }
+        case FrameMode::FULL_RATE:
+        default:
+            return now;
+    }
+}
+
+void FrameScheduler::waitForNextFrame() {
+    if (mode == FrameMode::FULL_RATE || isFrameDue()) {
+        return; // vsync in SDL_RenderPresent paces us
+    }
+
+    // Round up: the frame is not due yet, and a 0 ms timeout for the last
+    // sub-millisecond would spin the main loop until it is
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(nextDeadline() - Clock::now());
+    int timeoutMs = static_cast<int>(std::max<long long>(remaining.count(), 1));
+    // Passing nullptr waits for an event without removing it from the queue
+    SDL_WaitEventTimeout(nullptr, timeoutMs);
+}
+
+bool FrameScheduler::isFrameDue() const {
+    if (redrawRequested) {
+        return true;
+    }
+    switch (mode) {
+        case FrameMode::CAPPED:
+            return Clock::now() >= lastFrameStart + frameInterval;
+        case FrameMode::IDLE:
+            return time(nullptr) / 60 != lastDrawnMinute;
+        case FrameMode::FULL_RATE:
+        default:
+            return true;
+    }
+}
+
+float FrameScheduler::beginFrame() {
+    auto now = Clock::now();
+    float dt = std::chrono::duration<float>(now - lastFrameStart).count();
+    lastFrameStart = now;
+    lastDrawnMinute = time(nullptr) / 60;
+    redrawRequested = false;
+    return std::clamp(dt, 0.0f, MAX_FRAME_DT);
+}
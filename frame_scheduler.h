@@ -0,0 +1,62 @@
+// frame_scheduler.h
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include "config.h"
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+
+// Decides when the main loop should produce a frame.
+//  - FULL_RATE: every iteration, paced by vsync (snow animates smoothly)
+//  - CAPPED:    at most cappedFps frames per second, sleeping in between
+//  - IDLE:      only on the next minute boundary, on window events, or when
+//               a subsystem reports new data via requestWake(). Snow is
+//               frozen on purpose: the mode is for minimal CPU/GPU use, and
+//               animating it would mean drawing every frame again.
+class FrameScheduler {
+public:
+    FrameScheduler(FrameMode mode, int cappedFps);
+
+    void setMode(FrameMode mode, int cappedFps);
+    FrameMode getMode() const { return mode; }
+
+    // Sleep until the next frame is due or an SDL event is queued. Events are
+    // left in the queue for Clock::handleEvents().
+    void waitForNextFrame();
+
+    // True if a frame should be produced now
+    bool isFrameDue() const;
+
+    // Start a frame: returns elapsed seconds since the previous frame (clamped)
+    // and clears the pending redraw request
+    float beginFrame();
+
+    // Whether the snow should advance (false in IDLE mode)
+    bool isAnimating() const { return mode != FrameMode::IDLE; }
+
+    // Force the next frame to be drawn (main thread)
+    void invalidate() { redrawRequested = true; }
+
+    // Thread-safe: wake the main loop from a worker thread when its data changes
+    static void requestWake();
+    // True for the event requestWake() pushes
+    static bool isWakeEvent(const SDL_Event& event);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    FrameMode mode;
+    std::chrono::microseconds frameInterval;
+    Clock::time_point lastFrameStart;
+    time_t lastDrawnMinute;
+    bool redrawRequested;
+
+    static std::atomic<Uint32> wakeEventType;
+    static constexpr float MAX_FRAME_DT = 0.1f; // Avoid jumps after stalls
+
+    Clock::time_point nextDeadline() const;
+};
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,293 @@
+// glyph_atlas.cpp
+#include "glyph_atlas.h"
+#include "logger.h"
+#include <algorithm>
+
+namespace {
+
+int encodeUtf8(uint32_t cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    } else if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    } else if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas()
+    : font(nullptr)
+    , texture(nullptr)
+    , textureWidth(0)
+    , textureHeight(0)
+    , lineHeight(0)
+    , useKerning(false)
+{
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+uint32_t GlyphAtlas::decodeUtf8(std::string_view text, size_t& pos) {
+    const unsigned char c = static_cast<unsigned char>(text[pos++]);
+    if (c < 0x80) {
+        return c;
+    }
+
+    int extra = 0;
+    uint32_t cp = 0;
+    if ((c & 0xE0) == 0xC0) { extra = 1; cp = c & 0x1F; }
+    else if ((c & 0xF0) == 0xE0) { extra = 2; cp = c & 0x0F; }
+    else if ((c & 0xF8) == 0xF0) { extra = 3; cp = c & 0x07; }
+    else { return 0xFFFD; } // Stray continuation byte
+
+    for (int i = 0; i < extra; ++i) {
+        if (pos >= text.size() || (static_cast<unsigned char>(text[pos]) & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (static_cast<unsigned char>(text[pos++]) & 0x3F);
+    }
+    return cp;
+}
+
+bool GlyphAtlas::build(SDL_Renderer* renderer, TTF_Font* ttfFont, std::string_view charset) {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    glyphs.clear();
+    lookup.assign(LOOKUP_SIZE, -1);
+
+    font = ttfFont;
+    if (!renderer || !font) {
+        return false;
+    }
+    lineHeight = TTF_FontHeight(font);
+    useKerning = TTF_GetFontKerning(font) != 0;
+
+    // Keep within the renderer's texture limit (VideoCore IV tops out at 2048)
+    SDL_RendererInfo info;
+    int maxWidth = 2048;
+    int maxHeight = 2048;
+    if (SDL_GetRendererInfo(renderer, &info) == 0) {
+        if (info.max_texture_width > 0) maxWidth = std::min(maxWidth, info.max_texture_width);
+        if (info.max_texture_height > 0) maxHeight = std::min(maxHeight, info.max_texture_height);
+    }
+
+    // Rasterize each glyph on its own and shelf-pack them in rows
+    const int padding = 1;
+    const SDL_Color white = {255, 255, 255, 255};
+    std::vector<SDL_Surface*> surfaces;
+    int penX = padding;
+    int penY = padding;
+    int rowHeight = 0;
+    int usedWidth = 0;
+
+    size_t pos = 0;
+    while (pos < charset.size()) {
+        uint32_t cp = decodeUtf8(charset, pos);
+        if (cp >= LOOKUP_SIZE || lookup[cp] >= 0 || !TTF_GlyphIsProvided(font, static_cast<Uint16>(cp))) {
+            continue;
+        }
+
+        int advance = 0;
+        TTF_GlyphMetrics(font, static_cast<Uint16>(cp), nullptr, nullptr, nullptr, nullptr, &advance);
+
+        char utf8[5] = {0};
+        encodeUtf8(cp, utf8);
+        SDL_Surface* surface = TTF_RenderUTF8_Blended(font, utf8, white);
+        int w = surface ? surface->w : 0;
+        int h = surface ? surface->h : 0;
+
+        if (penX + w + padding > maxWidth) {
+            penX = padding;
+            penY += rowHeight + padding;
+            rowHeight = 0;
+        }
+
+        Glyph glyph;
+        glyph.src = { penX, penY, w, h };
+        glyph.advance = advance;
+        glyph.codepoint = static_cast<uint16_t>(cp);
+        lookup[cp] = static_cast<int16_t>(glyphs.size());
+        glyphs.push_back(glyph);
+        surfaces.push_back(surface);
+
+        penX += w + padding;
+        rowHeight = std::max(rowHeight, h);
+        usedWidth = std::max(usedWidth, penX);
+    }
+
+    const int totalHeight = penY + rowHeight + padding;
+    auto freeSurfaces = [&surfaces]() {
+        for (SDL_Surface* s : surfaces) {
+            if (s) SDL_FreeSurface(s);
+        }
+    };
+
+    if (glyphs.empty() || totalHeight > maxHeight) {
+        LOG_WARNING("Glyph atlas does not fit (%d glyphs, %dx%d), using string textures",
+                    static_cast<int>(glyphs.size()), usedWidth, totalHeight);
+        freeSurfaces();
+        glyphs.clear();
+        lookup.assign(LOOKUP_SIZE, -1);
+        return false;
+    }
+
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, usedWidth, totalHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlas) {
+        LOG_ERROR("Failed to create glyph atlas surface: %s", SDL_GetError());
+        freeSurfaces();
+        return false;
+    }
+    SDL_FillRect(atlas, nullptr, SDL_MapRGBA(atlas->format, 0, 0, 0, 0));
+
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+        if (!surfaces[i]) continue;
+        // Copy coverage as-is instead of blending it onto the transparent atlas
+        SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+        SDL_Rect dst = glyphs[i].src;
+        SDL_BlitSurface(surfaces[i], nullptr, atlas, &dst);
+    }
+    freeSurfaces();
+
+    texture = SDL_CreateTextureFromSurface(renderer, atlas);
+    SDL_FreeSurface(atlas);
+    if (!texture) {
+        LOG_ERROR("Failed to create glyph atlas texture: %s", SDL_GetError());
+        glyphs.clear();
+        lookup.assign(LOOKUP_SIZE, -1);
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    textureWidth = usedWidth;
+    textureHeight = totalHeight;
+
+    LOG_DEBUG("Glyph atlas built: %d glyphs, %dx%d", static_cast<int>(glyphs.size()), textureWidth, textureHeight);
+    return true;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::findGlyph(uint32_t codepoint) const {
+    if (codepoint >= lookup.size()) {
+        return nullptr;
+    }
+    int16_t index = lookup[codepoint];
+    return index >= 0 ? &glyphs[index] : nullptr;
+}
+
+int GlyphAtlas::kerning(const Glyph* previous, const Glyph* current) const {
+#ifdef SDL_TTF_VERSION_ATLEAST
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 14)
+    if (useKerning && previous) {
+        return TTF_GetFontKerningSizeGlyphs(font, previous->codepoint, current->codepoint);
+    }
+#endif
+#endif
+    (void)previous;
+    (void)current;
+    return 0;
+}
+
+bool GlyphAtlas::covers(std::string_view text) const {
+    if (!texture) {
+        return false;
+    }
+    size_t pos = 0;
+    while (pos < text.size()) {
+        if (!findGlyph(decodeUtf8(text, pos))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int GlyphAtlas::measureWidth(std::string_view text) const {
+    int width = 0;
+    const Glyph* previous = nullptr;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const Glyph* glyph = findGlyph(decodeUtf8(text, pos));
+        if (!glyph) continue;
+        width += kerning(previous, glyph) + glyph->advance;
+        previous = glyph;
+    }
+    return width;
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+void GlyphAtlas::appendQuads(std::string_view text, int x, int y, SDL_Color color,
+                             std::vector<SDL_Vertex>& vertices, std::vector<int>& indices) const {
+    if (!texture) return;
+
+    const float invW = 1.0f / textureWidth;
+    const float invH = 1.0f / textureHeight;
+    const Glyph* previous = nullptr;
+    int penX = x;
+    size_t pos = 0;
+
+    while (pos < text.size()) {
+        const Glyph* glyph = findGlyph(decodeUtf8(text, pos));
+        if (!glyph) continue;
+
+        penX += kerning(previous, glyph);
+        const SDL_Rect& src = glyph->src;
+        if (src.w > 0 && src.h > 0) {
+            const float x0 = static_cast<float>(penX), x1 = static_cast<float>(penX + src.w);
+            const float y0 = static_cast<float>(y), y1 = static_cast<float>(y + src.h);
+            const float u0 = src.x * invW, u1 = (src.x + src.w) * invW;
+            const float v0 = src.y * invH, v1 = (src.y + src.h) * invH;
+
+            const int base = static_cast<int>(vertices.size());
+            vertices.push_back({ { x0, y0 }, color, { u0, v0 } });
+            vertices.push_back({ { x1, y0 }, color, { u1, v0 } });
+            vertices.push_back({ { x1, y1 }, color, { u1, v1 } });
+            vertices.push_back({ { x0, y1 }, color, { u0, v1 } });
+            indices.insert(indices.end(), { base, base + 1, base + 2, base + 2, base + 3, base });
+        }
+        penX += glyph->advance;
+        previous = glyph;
+    }
+}
+#endif
+
+void GlyphAtlas::drawDirect(SDL_Renderer* renderer, std::string_view text, int x, int y, SDL_Color color) const {
+    if (!texture) return;
+
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+
+    const Glyph* previous = nullptr;
+    int penX = x;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const Glyph* glyph = findGlyph(decodeUtf8(text, pos));
+        if (!glyph) continue;
+
+        penX += kerning(previous, glyph);
+        if (glyph->src.w > 0 && glyph->src.h > 0) {
+            SDL_Rect dst = { penX, y, glyph->src.w, glyph->src.h };
+            SDL_RenderCopy(renderer, texture, &glyph->src, &dst);
+        }
+        penX += glyph->advance;
+        previous = glyph;
+    }
+
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(texture, 255);
+}
@@ -0,0 +1,75 @@
+// glyph_atlas.h
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Pre-rasterized glyphs for one font packed into a single white texture.
+// Strings are drawn as one textured quad per glyph (tinted through vertex
+// colors), so changing text never rasterizes or uploads anything.
+class GlyphAtlas {
+public:
+    GlyphAtlas();
+    ~GlyphAtlas();
+
+    // Rasterize every character of the UTF-8 charset. Returns false (and stays
+    // unusable) if the font is missing or the glyphs don't fit in one texture.
+    bool build(SDL_Renderer* renderer, TTF_Font* font, std::string_view charset);
+
+    bool isReady() const { return texture != nullptr; }
+
+    // True if every character of text is in the atlas
+    bool covers(std::string_view text) const;
+
+    // Width of text in pixels, including kerning
+    int measureWidth(std::string_view text) const;
+    int getLineHeight() const { return lineHeight; }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // Append one quad per glyph; (x, y) is the top-left of the text box
+    void appendQuads(std::string_view text, int x, int y, SDL_Color color,
+                     std::vector<SDL_Vertex>& vertices, std::vector<int>& indices) const;
+#endif
+
+    // Fallback for SDL < 2.0.18: one SDL_RenderCopy per glyph
+    void drawDirect(SDL_Renderer* renderer, std::string_view text, int x, int y, SDL_Color color) const;
+
+    SDL_Texture* getTexture() const { return texture; }
+    size_t getMemorySize() const { return static_cast<size_t>(textureWidth) * textureHeight * 4; }
+
+    // Decode the next UTF-8 code point at text[pos] and advance pos
+    static uint32_t decodeUtf8(std::string_view text, size_t& pos);
+
+private:
+    struct Glyph {
+        SDL_Rect src;    // Region in the atlas
+        int advance;     // Horizontal pen advance
+        uint16_t codepoint;
+    };
+
+    // Code points below this map through a flat table; covers Latin-1,
+    // Cyrillic and general punctuation (dashes, ellipsis, numero sign)
+    static constexpr uint32_t LOOKUP_SIZE = 0x2200;
+
+    std::vector<Glyph> glyphs;
+    std::vector<int16_t> lookup;   // code point -> index into glyphs, -1 if absent
+    TTF_Font* font;                // Non-owning, used for kerning queries
+    SDL_Texture* texture;
+    int textureWidth;
+    int textureHeight;
+    int lineHeight;
+    bool useKerning;
+
+    const Glyph* findGlyph(uint32_t codepoint) const;
+    int kerning(const Glyph* previous, const Glyph* current) const;
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+};
+
+#endif // GLYPH_ATLAS_H
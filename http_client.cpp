@@ -1,7 +1,7 @@
 #include "http_client.h"
 #include "logger.h"
+#include "memory_budget.h"
 #include <sstream>
-#include <type_traits>
 #include <string>
 
 // Circuit Breaker Implementation
@@ -100,25 +100,110 @@ std::string HTTPCircuitBreaker::getStateString() const {
 }
 
 // HTTP Client Implementation
+std::mutex HTTPClient::registryMutex;
+std::map<std::string, std::shared_ptr<HTTPClient>> HTTPClient::registry;
+
 HTTPClient::HTTPClient(const std::string& host, int port, bool useSSL, bool verifySSL)
-    : host(host), port(port), useSSL(useSSL), verifySSL(verifySSL), circuitBreaker(3, 2, 60)
+    : host(host), port(port), useSSL(useSSL), verifySSL(verifySSL), circuitBreaker(3, 2, 60),
+      lastUsed(std::chrono::steady_clock::now())
 {
-    LOG_INFO("HTTPClient created for %s://%s:%d", useSSL ? "https" : "http", host.c_str(), port);
+    if (useSSL) {
+        client = std::make_unique<httplib::SSLClient>(host, port);
+    } else {
+        client = std::make_unique<httplib::ClientImpl>(host, port);
+    }
+    client->set_keep_alive(true);
+    client->set_follow_location(true);
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+    client->set_decompress(true); // Sends Accept-Encoding: gzip, deflate
+#endif
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+    client->enable_server_certificate_verification(verifySSL);
+#endif
+    
+    LOG_INFO("HTTPClient created for %s://%s:%d (keep-alive)", useSSL ? "https" : "http", host.c_str(), port);
 }
 
-template<typename ClientType>
-void HTTPClient::configureClient(ClientType& client, int timeoutSeconds) {
-    client.set_connection_timeout(timeoutSeconds, 0);
-    client.set_read_timeout(timeoutSeconds, 0);
-    client.set_write_timeout(timeoutSeconds, 0);
-    client.set_follow_location(true);
+std::shared_ptr<HTTPClient> HTTPClient::forHost(const std::string& host, int port, bool useSSL) {
+    std::string key = std::string(useSSL ? "https://" : "http://") + host + ":" + std::to_string(port);
     
-    if constexpr (std::is_same_v<ClientType, httplib::SSLClient>) {
-        client.enable_server_certificate_verification(verifySSL);
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = registry.find(key);
+    if (it != registry.end()) {
+        return it->second;
+    }
+    
+    auto created = std::make_shared<HTTPClient>(host, port, useSSL);
+    registry.emplace(key, created);
+    return created;
+}
+
+void HTTPClient::reapIdleConnections() {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& entry : registry) {
+        // A busy client is by definition not idle; never block the caller on it
+        std::unique_lock<std::mutex> requestLock(entry.second->requestMutex, std::try_to_lock);
+        if (requestLock.owns_lock()) {
+            entry.second->closeIfIdle(now);
+        }
+    }
+}
+
+std::vector<std::pair<std::string, std::string>> HTTPClient::circuitStates() {
+    std::vector<std::pair<std::string, std::string>> states;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& entry : registry) {
+        states.emplace_back(entry.second->host, entry.second->circuitBreaker.getStateString());
+    }
+    return states;
+}
+
+void HTTPClient::closeIfIdle(std::chrono::steady_clock::time_point now) {
+    auto idle = std::chrono::duration_cast<std::chrono::seconds>(now - lastUsed);
+    if (idle.count() >= KEEP_ALIVE_IDLE_SECONDS && client->is_socket_open()) {
+        LOG_DEBUG("Closing idle connection to %s (%lld s)", host.c_str(), static_cast<long long>(idle.count()));
+        client->stop();
+    }
+}
+
+void HTTPClient::abort() {
+    // httplib's stop() is safe to call while another thread is inside a request
+    client->stop();
+}
+
+void HTTPClient::configureClient(int timeoutSeconds) {
+    client->set_connection_timeout(timeoutSeconds, 0);
+    client->set_read_timeout(timeoutSeconds, 0);
+    client->set_write_timeout(timeoutSeconds, 0);
+}
+
+void HTTPClient::handleResult(httplib::Result& res, Response& response, const char* method) {
+    if (res) {
+        response.statusCode = res->status;
+        response.body = std::move(res->body);
+        const bool http_ok = res->status >= 200 && res->status < 300;
+        response.success = http_ok;
+        if (http_ok) {
+            circuitBreaker.recordSuccess();
+            LOG_DEBUG("HTTP %s successful, status: %d", method, res->status);
+        } else {
+            response.error = "HTTP status " + std::to_string(res->status);
+            circuitBreaker.recordFailure();
+            LOG_ERROR("HTTP %s failed with status: %d", method, res->status);
+        }
+    } else {
+        response.error = httplib::to_string(res.error());
+        circuitBreaker.recordFailure();
+        LOG_ERROR("HTTP %s failed: %s", method, response.error.c_str());
     }
 }
 
 HTTPClient::Response HTTPClient::get(const std::string& path, int timeoutSeconds) {
+    return get(path, httplib::Headers{}, timeoutSeconds);
+}
+
+HTTPClient::Response HTTPClient::get(const std::string& path, const httplib::Headers& headers, int timeoutSeconds) {
     Response response{false, 0, "", ""};
     
     // Check circuit breaker
@@ -131,52 +216,70 @@ HTTPClient::Response HTTPClient::get(const std::string& path, int timeoutSeconds
     LOG_DEBUG("HTTP GET: %s://%s:%d%s", useSSL ? "https" : "http", host.c_str(), port, path.c_str());
     
     try {
-        if (useSSL) {
-            httplib::SSLClient client(host, port);
-            configureClient(client, timeoutSeconds);
-            
-            auto res = client.Get(path.c_str());
-            
-            if (res) {
-                response.statusCode = res->status;
-                response.body = res->body;
-                const bool http_ok = res->status >= 200 && res->status < 300;
-                response.success = http_ok;
-                if (http_ok) {
-                    circuitBreaker.recordSuccess();
-                    LOG_DEBUG("HTTP GET successful, status: %d", res->status);
-                } else {
-                    response.error = "HTTP status " + std::to_string(res->status);
-                    circuitBreaker.recordFailure();
-                    LOG_ERROR("HTTP GET failed with status: %d", res->status);
-                }
-            } else {
-                response.error = httplib::to_string(res.error());
-                circuitBreaker.recordFailure();
-                LOG_ERROR("HTTP GET failed: %s", response.error.c_str());
+        std::lock_guard<std::mutex> lock(requestMutex);
+        auto now = std::chrono::steady_clock::now();
+        closeIfIdle(now);  // The server has likely dropped it already
+        configureClient(timeoutSeconds);
+        
+        auto res = client->Get(path, headers);
+        lastUsed = std::chrono::steady_clock::now();
+        handleResult(res, response, "GET");
+    } catch (const std::exception& e) {
+        response.error = e.what();
+        circuitBreaker.recordFailure();
+        LOG_ERROR("HTTP GET exception: %s", e.what());
+    }
+    
+    return response;
+}
+
+HTTPClient::Response HTTPClient::getConditional(const std::string& path, int timeoutSeconds) {
+    Response response{false, 0, "", ""};
+    
+    // Check circuit breaker
+    if (!circuitBreaker.shouldAttempt()) {
+        response.error = "Circuit breaker is OPEN";
+        LOG_WARNING("HTTP GET blocked by circuit breaker: %s", path.c_str());
+        return response;
+    }
+    
+    LOG_DEBUG("HTTP conditional GET: %s://%s:%d%s", useSSL ? "https" : "http", host.c_str(), port, path.c_str());
+    
+    try {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        auto now = std::chrono::steady_clock::now();
+        closeIfIdle(now);
+        configureClient(timeoutSeconds);
+        
+        httplib::Headers headers;
+        auto known = validators.find(path);
+        if (known != validators.end()) {
+            if (!known->second.etag.empty()) {
+                headers.emplace("If-None-Match", known->second.etag);
             }
-        } else {
-            httplib::Client client(host, port);
-            configureClient(client, timeoutSeconds);
-            
-            auto res = client.Get(path.c_str());
-            
-            if (res) {
-                response.statusCode = res->status;
-                response.body = res->body;
-                const bool http_ok = res->status >= 200 && res->status < 300;
-                response.success = http_ok;
-                if (http_ok) {
-                    circuitBreaker.recordSuccess();
-                } else {
-                    response.error = "HTTP status " + std::to_string(res->status);
-                    circuitBreaker.recordFailure();
-                }
-            } else {
-                response.error = httplib::to_string(res.error());
-                circuitBreaker.recordFailure();
+            if (!known->second.lastModified.empty()) {
+                headers.emplace("If-Modified-Since", known->second.lastModified);
             }
         }
+        
+        auto res = client->Get(path, headers);
+        lastUsed = std::chrono::steady_clock::now();
+        
+        if (res && res->status == 304) {
+            response.success = true;
+            response.statusCode = 304;
+            response.notModified = true;
+            circuitBreaker.recordSuccess();
+            LOG_DEBUG("HTTP GET not modified: %s", path.c_str());
+            return response;
+        }
+        
+        if (res && res->status == 200) {
+            Validators& stored = validators[path];
+            stored.etag = res->get_header_value("ETag");
+            stored.lastModified = res->get_header_value("Last-Modified");
+        }
+        handleResult(res, response, "GET");
     } catch (const std::exception& e) {
         response.error = e.what();
         circuitBreaker.recordFailure();
@@ -186,6 +289,74 @@ HTTPClient::Response HTTPClient::get(const std::string& path, int timeoutSeconds
     return response;
 }
 
+void HTTPClient::forgetValidators(const std::string& path) {
+    std::lock_guard<std::mutex> lock(requestMutex);
+    validators.erase(path);
+}
+
+HTTPClient::Response HTTPClient::download(const std::string& path, size_t maxBytes, int timeoutSeconds) {
+    Response response{false, 0, "", ""};
+    
+    // Check circuit breaker
+    if (!circuitBreaker.shouldAttempt()) {
+        response.error = "Circuit breaker is OPEN";
+        LOG_WARNING("HTTP download blocked by circuit breaker: %s", path.c_str());
+        return response;
+    }
+    
+    LOG_DEBUG("HTTP download: %s://%s:%d%s (cap %zu bytes)", useSSL ? "https" : "http", host.c_str(), port,
+              path.c_str(), maxBytes);
+    
+    std::string body;
+    bool tooLarge = false;
+    MemoryCharge bodyCharge(MemoryPool::HTTP, MemoryKind::CPU);  // Until the caller takes the body
+    
+    try {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        auto now = std::chrono::steady_clock::now();
+        closeIfIdle(now);
+        configureClient(timeoutSeconds);
+        
+        auto res = client->Get(path, httplib::Headers{},
+            [&](const httplib::Response& head) {
+                body.clear(); // A redirect starts over
+                uint64_t length = head.get_header_value_u64("Content-Length", 0);
+                if (length > maxBytes) {
+                    tooLarge = true;
+                    return false;
+                }
+                body.reserve(static_cast<size_t>(length));
+                bodyCharge.resize(body.capacity());
+                return true;
+            },
+            [&](const char* data, size_t size) {
+                if (body.size() + size > maxBytes) {
+                    tooLarge = true;
+                    return false;
+                }
+                body.append(data, size);
+                bodyCharge.resize(body.capacity());
+                return true;
+            });
+        lastUsed = std::chrono::steady_clock::now();
+        
+        if (tooLarge) {
+            // The server is fine; don't count this against the circuit breaker
+            response.error = "Response exceeds " + std::to_string(maxBytes) + " bytes";
+            LOG_ERROR("HTTP download aborted: %s", response.error.c_str());
+        } else {
+            handleResult(res, response, "download");
+            response.body = std::move(body);
+        }
+    } catch (const std::exception& e) {
+        response.error = e.what();
+        circuitBreaker.recordFailure();
+        LOG_ERROR("HTTP download exception: %s", e.what());
+    }
+    
+    return response;
+}
+
 HTTPClient::Response HTTPClient::post(
     const std::string& path,
     const std::string& body,
@@ -205,52 +376,14 @@ HTTPClient::Response HTTPClient::post(
     LOG_DEBUG("HTTP POST: %s://%s:%d%s", useSSL ? "https" : "http", host.c_str(), port, path.c_str());
     
     try {
-        if (useSSL) {
-            httplib::SSLClient client(host, port);
-            configureClient(client, timeoutSeconds);
-            
-            auto res = client.Post(path.c_str(), headers, body, contentType.c_str());
-            
-            if (res) {
-                response.statusCode = res->status;
-                response.body = res->body;
-                const bool http_ok = res->status >= 200 && res->status < 300;
-                response.success = http_ok;
-                if (http_ok) {
-                    circuitBreaker.recordSuccess();
-                    LOG_DEBUG("HTTP POST successful, status: %d", res->status);
-                } else {
-                    response.error = "HTTP status " + std::to_string(res->status);
-                    circuitBreaker.recordFailure();
-                    LOG_ERROR("HTTP POST failed with status: %d", res->status);
-                }
-            } else {
-                response.error = httplib::to_string(res.error());
-                circuitBreaker.recordFailure();
-                LOG_ERROR("HTTP POST failed: %s", response.error.c_str());
-            }
-        } else {
-            httplib::Client client(host, port);
-            configureClient(client, timeoutSeconds);
-            
-            auto res = client.Post(path.c_str(), headers, body, contentType.c_str());
-            
-            if (res) {
-                response.statusCode = res->status;
-                response.body = res->body;
-                const bool http_ok = res->status >= 200 && res->status < 300;
-                response.success = http_ok;
-                if (http_ok) {
-                    circuitBreaker.recordSuccess();
-                } else {
-                    response.error = "HTTP status " + std::to_string(res->status);
-                    circuitBreaker.recordFailure();
-                }
-            } else {
-                response.error = httplib::to_string(res.error());
-                circuitBreaker.recordFailure();
-            }
-        }
+        std::lock_guard<std::mutex> lock(requestMutex);
+        auto now = std::chrono::steady_clock::now();
+        closeIfIdle(now);
+        configureClient(timeoutSeconds);
+        
+        auto res = client->Post(path, headers, body, contentType);
+        lastUsed = std::chrono::steady_clock::now();
+        handleResult(res, response, "POST");
     } catch (const std::exception& e) {
         response.error = e.what();
         circuitBreaker.recordFailure();
@@ -258,4 +391,4 @@ HTTPClient::Response HTTPClient::post(
     }
     
     return response;
-}
\ No newline at end of file
+}
@@ -5,6 +5,9 @@
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <memory>
+#include <map>
+#include <vector>
 #include <httplib.h>
 
 class HTTPCircuitBreaker {
@@ -50,12 +53,35 @@ public:
         int statusCode;
         std::string body;
         std::string error;
+        bool notModified = false;  // 304 from getConditional(); body is empty, reuse the last result
     };
     
     HTTPClient(const std::string& host, int port = 443, bool useSSL = true, bool verifySSL = true);
     
+    // Shared per-host client. Every caller talking to the same host reuses one
+    // keep-alive connection and one circuit breaker.
+    static std::shared_ptr<HTTPClient> forHost(const std::string& host, int port = 443, bool useSSL = true);
+    
+    // Close pooled connections that have been idle longer than KEEP_ALIVE_IDLE_SECONDS
+    static void reapIdleConnections();
+
+    // Host and circuit breaker state of every pooled client, for monitoring
+    static std::vector<std::pair<std::string, std::string>> circuitStates();
+    
     // GET request with circuit breaker protection
     Response get(const std::string& path, int timeoutSeconds = 5);
+    Response get(const std::string& path, const httplib::Headers& headers, int timeoutSeconds);
+    
+    // GET with validators: sends the ETag / Last-Modified remembered from the
+    // last 200 for this path and reports a 304 as success with notModified set
+    Response getConditional(const std::string& path, int timeoutSeconds = 5);
+    
+    // Drop the validators for path, e.g. when its last body could not be parsed
+    void forgetValidators(const std::string& path);
+    
+    // Streaming GET for large bodies: reserves the buffer from Content-Length
+    // and aborts as soon as the body would exceed maxBytes
+    Response download(const std::string& path, size_t maxBytes, int timeoutSeconds = 5);
     
     // POST request with circuit breaker protection
     Response post(const std::string& path, const std::string& body,
@@ -68,6 +94,12 @@ public:
         return circuitBreaker.getState();
     }
     
+    // Abort a request in flight from another thread (the connection is reopened on next use)
+    void abort();
+    
+    // Idle time after which the pooled connection is closed; servers usually drop theirs sooner
+    static constexpr int KEEP_ALIVE_IDLE_SECONDS = 30;
+    
 private:
     std::string host;
     int port;
@@ -75,9 +107,26 @@ private:
     bool verifySSL;
     HTTPCircuitBreaker circuitBreaker;
     
-    // Helper to configure client with timeouts
-    template<typename ClientType>
-    void configureClient(ClientType& client, int timeoutSeconds);
+    // Pooled keep-alive connection. Created once so abort() can reach it without locking.
+    std::unique_ptr<httplib::ClientImpl> client;
+    std::mutex requestMutex;  // httplib clients serve one request at a time
+    std::chrono::steady_clock::time_point lastUsed;
+    
+    struct Validators {
+        std::string etag;
+        std::string lastModified;
+    };
+    std::map<std::string, Validators> validators;  // Per path, guarded by requestMutex
+    
+    static std::mutex registryMutex;
+    static std::map<std::string, std::shared_ptr<HTTPClient>> registry;
+    
+    // Helper to configure client with timeouts (requestMutex held)
+    void configureClient(int timeoutSeconds);
+    void closeIfIdle(std::chrono::steady_clock::time_point now);
+    
+    // Records the outcome in the circuit breaker and fills response
+    void handleResult(httplib::Result& res, Response& response, const char* method);
 };
 
 #endif // HTTP_CLIENT_H
\ No newline at end of file
@@ -0,0 +1,133 @@
+// image_decode.cpp
+#include "image_decode.h"
+#include "logger.h"
+#include <SDL2/SDL_image.h>
+
+#ifdef HAVE_LIBJPEG
+#include <csetjmp>
+#include <cstdio>   // jpeglib.h needs FILE
+#include <jpeglib.h>
+
+namespace {
+
+struct JpegErrorManager {
+    jpeg_error_mgr base;
+    jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void jpegErrorExit(j_common_ptr cinfo) {
+    JpegErrorManager* manager = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+    (*cinfo->err->format_message)(cinfo, manager->message);
+    longjmp(manager->jump, 1);
+}
+
+// Warnings (e.g. a truncated file, which decodes with a grey tail) go to our log, not stderr
+void jpegOutputMessage(j_common_ptr cinfo) {
+    char message[JMSG_LENGTH_MAX];
+    (*cinfo->err->format_message)(cinfo, message);
+    LOG_WARNING("libjpeg: %s", message);
+}
+
+// Only plain C objects live in this function: longjmp skips destructors
+SDL_Surface* decodeJpeg(const uint8_t* data, size_t size, int minWidth, int minHeight,
+                        DecodedImageInfo* info) {
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager error;
+    SDL_Surface* volatile surface = nullptr;
+
+    cinfo.err = jpeg_std_error(&error.base);
+    error.base.error_exit = jpegErrorExit;
+    error.base.output_message = jpegOutputMessage;
+    if (setjmp(error.jump)) {
+        SDL_SetError("libjpeg: %s", error.message);
+        jpeg_destroy_decompress(&cinfo);
+        if (surface) SDL_FreeSurface(surface);
+        return nullptr;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, const_cast<unsigned char*>(data), static_cast<unsigned long>(size));
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+
+    // Smallest n/8 scale whose output still covers the target (crop-to-fill needs both sides)
+    cinfo.scale_denom = 8;
+    for (unsigned int num = 1; num <= 8; ++num) {
+        cinfo.scale_num = num;
+        jpeg_calc_output_dimensions(&cinfo);
+        if (static_cast<int>(cinfo.output_width) >= minWidth &&
+            static_cast<int>(cinfo.output_height) >= minHeight) {
+            break;
+        }
+    }
+
+    jpeg_start_decompress(&cinfo);
+    if (cinfo.output_components != 3) {
+        SDL_SetError("libjpeg: unexpected component count %d", cinfo.output_components);
+        jpeg_destroy_decompress(&cinfo);
+        return nullptr;
+    }
+
+    surface = SDL_CreateRGBSurfaceWithFormat(0, cinfo.output_width, cinfo.output_height,
+                                             24, SDL_PIXELFORMAT_RGB24);
+    if (!surface) {
+        jpeg_destroy_decompress(&cinfo);
+        return nullptr;
+    }
+
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = static_cast<JSAMPLE*>(surface->pixels) +
+                       static_cast<size_t>(cinfo.output_scanline) * surface->pitch;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+
+    if (info) {
+        info->sourceWidth = static_cast<int>(cinfo.image_width);
+        info->sourceHeight = static_cast<int>(cinfo.image_height);
+        info->scaleNum = static_cast<int>(cinfo.scale_num);
+        info->decoder = "libjpeg";
+    }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return surface;
+}
+
+} // namespace
+#endif // HAVE_LIBJPEG
+
+SDL_Surface* decodeImageScaled(const uint8_t* data, size_t size, int minWidth, int minHeight,
+                               DecodedImageInfo* info) {
+#ifdef HAVE_LIBJPEG
+    const bool isJpeg = size > 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+    if (isJpeg) {
+        SDL_Surface* surface = decodeJpeg(data, size, minWidth, minHeight, info);
+        if (surface) {
+            return surface;
+        }
+        LOG_WARNING("Scaled JPEG decode failed (%s), falling back to SDL_image", SDL_GetError());
+    }
+#else
+    (void)minWidth;
+    (void)minHeight;
+#endif
+
+    SDL_RWops* rw = SDL_RWFromConstMem(data, static_cast<int>(size));
+    if (!rw) {
+        return nullptr;
+    }
+    SDL_Surface* surface = IMG_Load_RW(rw, 1);
+    if (!surface) {
+        SDL_SetError("IMG_Load_RW failed: %s", IMG_GetError());
+        return nullptr;
+    }
+
+    if (info) {
+        info->sourceWidth = surface->w;
+        info->sourceHeight = surface->h;
+        info->scaleNum = 8;
+        info->decoder = "SDL_image";
+    }
+    return surface;
+}
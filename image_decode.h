@@ -0,0 +1,24 @@
+// image_decode.h
+#ifndef IMAGE_DECODE_H
+#define IMAGE_DECODE_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+
+struct DecodedImageInfo {
+    int sourceWidth = 0;       // Dimensions encoded in the file
+    int sourceHeight = 0;
+    int scaleNum = 8;          // Decoded at scaleNum/8 of the source size
+    const char* decoder = "";  // "libjpeg" or "SDL_image"
+};
+
+// Decodes a compressed image. JPEGs are decoded with libjpeg's DCT scaling
+// (when built with HAVE_LIBJPEG) at the smallest scale that still covers
+// minWidth x minHeight, one scanline at a time, so a 4K source never exists
+// as a full-resolution bitmap. Other formats, and JPEGs libjpeg rejects, go
+// through SDL_image at full size. Returns nullptr on failure (see SDL_GetError()).
+SDL_Surface* decodeImageScaled(const uint8_t* data, size_t size, int minWidth, int minHeight,
+                               DecodedImageInfo* info);
+
+#endif // IMAGE_DECODE_H
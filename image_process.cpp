@@ -0,0 +1,131 @@
+// image_process.cpp
+#include "image_process.h"
+#include <algorithm>
+#include <cmath>
+
+#if !defined(IMAGE_SCALAR_KERNEL) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define IMAGE_KERNEL_NEON 1
+#include <arm_neon.h>
+#elif !defined(IMAGE_SCALAR_KERNEL) && (defined(__SSE2__) || defined(_M_X64))
+#define IMAGE_KERNEL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+const char* imageKernelName() {
+#if defined(IMAGE_KERNEL_NEON)
+    return "NEON";
+#elif defined(IMAGE_KERNEL_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+SDL_Rect cropToFill(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight) {
+    SDL_Rect crop = {0, 0, sourceWidth, sourceHeight};
+    if (sourceWidth <= 0 || sourceHeight <= 0 || targetWidth <= 0 || targetHeight <= 0) {
+        return crop;
+    }
+
+    // Compare aspect ratios without floating point: sw/sh vs tw/th
+    const long long lhs = static_cast<long long>(sourceWidth) * targetHeight;
+    const long long rhs = static_cast<long long>(targetWidth) * sourceHeight;
+    if (lhs > rhs) {
+        // Source is wider: trim the sides
+        crop.w = static_cast<int>(rhs / targetHeight);
+        crop.x = (sourceWidth - crop.w) / 2;
+    } else if (lhs < rhs) {
+        // Source is taller: trim top and bottom
+        crop.h = static_cast<int>(lhs / targetWidth);
+        crop.y = (sourceHeight - crop.h) / 2;
+    }
+    return crop;
+}
+
+void darkenPixels32(uint8_t* pixels, int width, int height, int pitch, uint16_t scale, int alphaByte) {
+    // Per-byte multipliers for one pixel; 256 keeps a byte unchanged
+    uint16_t lane[8];
+    for (int i = 0; i < 8; ++i) {
+        lane[i] = (i % 4 == alphaByte) ? 256 : scale;
+    }
+
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = pixels + static_cast<size_t>(y) * pitch;
+        size_t x = 0;
+
+#if defined(IMAGE_KERNEL_NEON)
+        const uint16x8_t mul = vld1q_u16(lane);
+        for (; x + 16 <= rowBytes; x += 16) {
+            uint8x16_t v = vld1q_u8(row + x);
+            uint16x8_t lo = vmulq_u16(vmovl_u8(vget_low_u8(v)), mul);
+            uint16x8_t hi = vmulq_u16(vmovl_u8(vget_high_u8(v)), mul);
+            vst1q_u8(row + x, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+        }
+#elif defined(IMAGE_KERNEL_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mul = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane));
+        for (; x + 16 <= rowBytes; x += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), mul), 8);
+            __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), mul), 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        // 16-byte blocks start on pixel boundaries, so the tail keeps the lane pattern
+        for (; x < rowBytes; ++x) {
+            row[x] = static_cast<uint8_t>((row[x] * lane[x % 4]) >> 8);
+        }
+    }
+}
+
+SDL_Surface* prepareBackgroundSurface(SDL_Surface* source, int width, int height,
+                                      Uint32 format, double darkness) {
+    if (!source || width <= 0 || height <= 0) {
+        SDL_SetError("prepareBackgroundSurface: invalid arguments");
+        return nullptr;
+    }
+
+    SDL_Surface* result = SDL_CreateRGBSurfaceWithFormat(0, width, height, SDL_BITSPERPIXEL(format), format);
+    if (!result) {
+        return nullptr;
+    }
+
+    // Crop to the target aspect ratio, then scale and convert in a single blit.
+    // Copy pixels straight through rather than blending them onto the new surface.
+    // The source's blend mode is restored afterwards, so callers see it unchanged.
+    SDL_Rect crop = cropToFill(source->w, source->h, width, height);
+    SDL_BlendMode sourceBlend = SDL_BLENDMODE_NONE;
+    SDL_GetSurfaceBlendMode(source, &sourceBlend);
+    SDL_SetSurfaceBlendMode(source, SDL_BLENDMODE_NONE);
+    const int blitResult = SDL_BlitScaled(source, &crop, result, nullptr);
+    SDL_SetSurfaceBlendMode(source, sourceBlend);
+    if (blitResult < 0) {
+        SDL_FreeSurface(result);
+        return nullptr;
+    }
+
+    // Bake the darkening in (same result as a black overlay with alpha = darkness)
+    if (darkness > 0.0 && SDL_BYTESPERPIXEL(format) == 4) {
+        const double keep = 1.0 - std::min(darkness, 1.0);
+        const uint16_t scale = static_cast<uint16_t>(std::lround(keep * 256.0));
+
+        int alphaByte = -1;
+        if (result->format->Amask) {
+            int shift = 0;
+            while (!((result->format->Amask >> shift) & 1u)) ++shift;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            alphaByte = shift / 8;
+#else
+            alphaByte = 3 - shift / 8;
+#endif
+        }
+
+        if (SDL_MUSTLOCK(result)) SDL_LockSurface(result);
+        darkenPixels32(static_cast<uint8_t*>(result->pixels), result->w, result->h,
+                       result->pitch, scale, alphaByte);
+        if (SDL_MUSTLOCK(result)) SDL_UnlockSurface(result);
+    }
+
+    return result;
+}
@@ -0,0 +1,26 @@
+// image_process.h
+#ifndef IMAGE_PROCESS_H
+#define IMAGE_PROCESS_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+
+// Background post-process stage, run once per image on a worker thread:
+// crop-to-fill, scale and convert to the texture format, then darken.
+// Returns a new surface of exactly width x height, or nullptr (SDL_GetError()
+// has the reason). The source surface is not modified.
+SDL_Surface* prepareBackgroundSurface(SDL_Surface* source, int width, int height,
+                                      Uint32 format, double darkness);
+
+// Source rectangle with the target's aspect ratio, centered in the source
+SDL_Rect cropToFill(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight);
+
+// Multiplies the colour channels of 32-bit pixels by scale/256, leaving the
+// byte at alphaByte alone (pass -1 when there is no alpha channel)
+void darkenPixels32(uint8_t* pixels, int width, int height, int pitch, uint16_t scale, int alphaByte);
+
+// Name of the darkening kernel compiled in ("NEON", "SSE2" or "scalar")
+const char* imageKernelName();
+
+#endif // IMAGE_PROCESS_H
@@ -0,0 +1,222 @@
+// io_executor.cpp
+#include "io_executor.h"
+#include "logger.h"
+#include <algorithm>
+#include <exception>
+
+constexpr IOExecutor::Duration IOExecutor::TICK;
+constexpr size_t IOExecutor::WHEEL_SLOTS;
+thread_local IOExecutor::JobId IOExecutor::currentJob = 0;
+
+IOExecutor::IOExecutor(size_t threadCount)
+    : threadCount(std::max<size_t>(1, threadCount))
+    , running(false)
+    , wheel(WHEEL_SLOTS)
+    , timerCount(0)
+    , wheelStart(Clock::now())
+    , currentTick(0)
+    , nextId(1)
+{
+}
+
+IOExecutor::~IOExecutor() {
+    stop();
+}
+
+void IOExecutor::start() {
+    if (!running.exchange(true)) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back(&IOExecutor::workerLoop, this);
+        }
+        LOG_INFO("IOExecutor started with %zu threads", threadCount);
+    }
+}
+
+void IOExecutor::stop() {
+    if (running.exchange(false)) {
+        workAvailable.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers.clear();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        readyQueue.clear();
+        for (auto& slot : wheel) {
+            slot.clear();
+        }
+        timerCount = 0;
+        jobs.clear();
+        jobFinished.notify_all();
+        LOG_INFO("IOExecutor stopped");
+    }
+}
+
+IOExecutor::JobId IOExecutor::post(std::function<void()> task) {
+    return schedule(Duration(0), std::move(task));
+}
+
+IOExecutor::JobId IOExecutor::schedule(Duration delay, std::function<void()> task) {
+    auto job = std::make_shared<Job>();
+    job->task = [task = std::move(task)]() { task(); return true; };
+    return addJob(std::move(job), delay);
+}
+
+IOExecutor::JobId IOExecutor::schedulePeriodic(Duration interval, RetryPolicy retry, std::function<bool()> task) {
+    auto job = std::make_shared<Job>();
+    job->task = std::move(task);
+    job->interval = std::max(interval, TICK);
+    job->retry = retry;
+    job->nextRetry = retry.initial;
+    return addJob(std::move(job), Duration(0));
+}
+
+IOExecutor::JobId IOExecutor::addJob(JobPtr job, Duration delay) {
+    JobId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = nextId++;
+        job->id = id;
+        jobs.emplace(id, job);
+        if (delay <= Duration(0)) {
+            readyQueue.push_back(job);
+        } else {
+            insertTimerLocked(job, delay);
+        }
+    }
+    // Wake a worker to run it, or to shorten its sleep to the new deadline
+    workAvailable.notify_one();
+    return id;
+}
+
+void IOExecutor::cancel(JobId id) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end()) {
+        return;
+    }
+
+    JobPtr job = it->second;
+    job->cancelled = true;
+    jobs.erase(it); // Queue and wheel entries are dropped when reached
+
+    if (currentJob == id) {
+        return; // Cancelling ourselves; waiting would deadlock
+    }
+    jobFinished.wait(lock, [&job]() { return !job->running; });
+}
+
+void IOExecutor::insertTimerLocked(const JobPtr& job, Duration delay) {
+    auto due = Clock::now() + delay - wheelStart;
+    uint64_t tick = static_cast<uint64_t>((due + TICK - Duration(1)) / TICK); // Round up
+    if (tick <= currentTick) {
+        readyQueue.push_back(job);
+        return;
+    }
+    job->dueTick = tick;
+    wheel[tick % WHEEL_SLOTS].push_back(job);
+    ++timerCount;
+}
+
+void IOExecutor::advanceWheelLocked(Clock::time_point now) {
+    uint64_t nowTick = static_cast<uint64_t>((now - wheelStart) / TICK);
+    if (nowTick <= currentTick) {
+        return;
+    }
+
+    // After a long stall every slot has been passed at most once
+    uint64_t steps = std::min<uint64_t>(nowTick - currentTick, WHEEL_SLOTS);
+    for (uint64_t i = 1; i <= steps; ++i) {
+        auto& slot = wheel[(currentTick + i) % WHEEL_SLOTS];
+        for (size_t j = 0; j < slot.size();) {
+            if (slot[j]->cancelled || slot[j]->dueTick <= nowTick) {
+                if (!slot[j]->cancelled) {
+                    readyQueue.push_back(std::move(slot[j]));
+                }
+                slot[j] = std::move(slot.back());
+                slot.pop_back();
+                --timerCount;
+            } else {
+                ++j; // Due in a later revolution
+            }
+        }
+    }
+    currentTick = nowTick;
+}
+
+bool IOExecutor::nextWakeLocked(Clock::time_point& wake) const {
+    if (timerCount == 0) {
+        return false;
+    }
+    // Wake at the first occupied slot; entries due in a later revolution
+    // cost one spurious wake-up per revolution
+    for (uint64_t k = 1; k <= WHEEL_SLOTS; ++k) {
+        if (!wheel[(currentTick + k) % WHEEL_SLOTS].empty()) {
+            wake = wheelStart + TICK * static_cast<Duration::rep>(currentTick + k);
+            return true;
+        }
+    }
+    return false;
+}
+
+void IOExecutor::finishJobLocked(const JobPtr& job, bool success) {
+    job->running = false;
+
+    if (job->cancelled || job->interval == Duration(0)) {
+        jobs.erase(job->id);
+    } else {
+        Duration delay = job->interval;
+        if (success) {
+            job->nextRetry = job->retry.initial;
+        } else {
+            delay = job->nextRetry;
+            job->nextRetry = std::min(job->nextRetry * 2, job->retry.max);
+            LOG_DEBUG("IOExecutor job %llu failed, retrying in %lld ms",
+                      static_cast<unsigned long long>(job->id), static_cast<long long>(delay.count()));
+        }
+        insertTimerLocked(job, delay);
+    }
+    jobFinished.notify_all();
+}
+
+void IOExecutor::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        advanceWheelLocked(Clock::now());
+
+        if (!readyQueue.empty()) {
+            JobPtr job = std::move(readyQueue.front());
+            readyQueue.pop_front();
+            if (job->cancelled) {
+                continue;
+            }
+
+            job->running = true;
+            currentJob = job->id;
+            lock.unlock();
+
+            bool success = false;
+            try {
+                success = job->task();
+            } catch (const std::exception& e) {
+                LOG_ERROR("Exception in IOExecutor job: %s", e.what());
+            } catch (...) {
+                LOG_ERROR("Unknown exception in IOExecutor job");
+            }
+
+            lock.lock();
+            currentJob = 0;
+            finishJobLocked(job, success);
+            continue;
+        }
+
+        Clock::time_point wake;
+        if (nextWakeLocked(wake)) {
+            workAvailable.wait_until(lock, wake);
+        } else {
+            workAvailable.wait(lock);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+// io_executor.h
+#ifndef IO_EXECUTOR_H
+#define IO_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Shared executor for all blocking network work. A small fixed pool of
+// threads runs one-shot jobs and periodic jobs; periodic jobs are kept in a
+// hashed timer wheel and retried with exponential backoff when they fail.
+// Idle workers sleep until the next occupied wheel slot, so an idle
+// executor does not wake up at all.
+class IOExecutor {
+public:
+    using JobId = uint64_t;
+    using Duration = std::chrono::milliseconds;
+
+    // Retry delay after a failed periodic run: starts at initial and doubles up to max
+    struct RetryPolicy {
+        Duration initial;
+        Duration max;
+    };
+
+    explicit IOExecutor(size_t threadCount);
+    ~IOExecutor();
+
+    void start();
+    void stop();   // Drops queued jobs and joins the workers (running jobs finish first)
+
+    // Run a job as soon as a worker is free
+    JobId post(std::function<void()> task);
+
+    // Run a job once after delay
+    JobId schedule(Duration delay, std::function<void()> task);
+
+    // Run a job now and then every interval. The task returns false on
+    // failure, in which case it is retried according to retry instead.
+    JobId schedulePeriodic(Duration interval, RetryPolicy retry, std::function<bool()> task);
+
+    // Cancel a job. If it is running, blocks until it returns, so the
+    // caller may free whatever the job uses (inside the job itself it only
+    // marks it cancelled).
+    void cancel(JobId id);
+
+    size_t getThreadCount() const { return threadCount; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        JobId id;
+        std::function<bool()> task;
+        Duration interval{0};     // Zero for one-shot jobs
+        RetryPolicy retry{Duration(0), Duration(0)};
+        Duration nextRetry{0};
+        uint64_t dueTick = 0;
+        bool cancelled = false;
+        bool running = false;
+    };
+    using JobPtr = std::shared_ptr<Job>;
+
+    static constexpr Duration TICK{100};
+    static constexpr size_t WHEEL_SLOTS = 512;   // ~51 s per revolution
+
+    const size_t threadCount;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running;
+
+    mutable std::mutex mutex; // Protects everything below and all Job fields
+    std::condition_variable workAvailable;
+    std::condition_variable jobFinished;
+
+    std::unordered_map<JobId, JobPtr> jobs;
+    std::deque<JobPtr> readyQueue;
+    std::vector<std::vector<JobPtr>> wheel;
+    size_t timerCount;
+    Clock::time_point wheelStart;
+    uint64_t currentTick;
+    JobId nextId;
+
+    void workerLoop();
+    JobId addJob(JobPtr job, Duration delay);
+    void insertTimerLocked(const JobPtr& job, Duration delay);
+    void advanceWheelLocked(Clock::time_point now);
+    bool nextWakeLocked(Clock::time_point& wake) const;
+    void finishJobLocked(const JobPtr& job, bool success);
+
+    static thread_local JobId currentJob;
+
+    // Prevent copying
+    IOExecutor(const IOExecutor&) = delete;
+    IOExecutor& operator=(const IOExecutor&) = delete;
+};
+
+#endif // IO_EXECUTOR_H
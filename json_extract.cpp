@@ -0,0 +1,210 @@
+// json_extract.cpp
+#include "json_extract.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Tracks where in the document the parser is and forwards scalar values.
+// Each frame is an open object (current key) or array (current index).
+class PathSax : public nlohmann::json_sax<json> {
+public:
+    struct Frame {
+        bool isArray;
+        std::string key;
+        size_t index;
+    };
+
+    std::string error;
+
+    bool null() override { return element() && onNull(); }
+    bool boolean(bool) override { return element(); }
+    bool number_integer(number_integer_t value) override { return element() && onNumber(static_cast<double>(value)); }
+    bool number_unsigned(number_unsigned_t value) override { return element() && onNumber(static_cast<double>(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return element() && onNumber(value); }
+    bool string(string_t& value) override { return element() && onString(value); }
+    bool binary(binary_t&) override { return element(); }
+
+    bool start_object(std::size_t) override {
+        if (!element()) return false;
+        path.push_back({false, std::string(), 0});
+        return true;
+    }
+    bool key(string_t& value) override {
+        path.back().key = value;
+        return true;
+    }
+    bool end_object() override {
+        path.pop_back();
+        return true;
+    }
+    bool start_array(std::size_t) override {
+        if (!element()) return false;
+        path.push_back({true, std::string(), std::numeric_limits<size_t>::max()});
+        return true;
+    }
+    bool end_array() override {
+        path.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error = ex.what();
+        return false;
+    }
+
+protected:
+    std::vector<Frame> path;
+
+    // Return false to stop parsing early
+    virtual bool onNumber(double) { return true; }
+    virtual bool onString(const std::string&) { return true; }
+    virtual bool onNull() { return true; }
+
+    bool keyIs(size_t level, const char* name) const {
+        return level < path.size() && !path[level].isArray && path[level].key == name;
+    }
+
+private:
+    // Advances the index of an enclosing array before each of its elements
+    bool element() {
+        if (!path.empty() && path.back().isArray) {
+            ++path.back().index; // Wraps from max to 0 on the first element
+        }
+        return true;
+    }
+};
+
+// Local time of an open-meteo "YYYY-MM-DDTHH:MM" stamp (timezone=auto)
+time_t parseLocalHour(const std::string& stamp) {
+    std::tm tm{};
+    if (std::sscanf(stamp.c_str(), "%d-%d-%dT%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                    &tm.tm_hour, &tm.tm_min) != 5) {
+        return 0;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
+
+class WeatherSax : public PathSax {
+public:
+    explicit WeatherSax(WeatherData& out) : out(out) {}
+
+    bool haveTemperature = false;
+    bool haveCode = false;
+    bool haveWind = false;
+    size_t apparentCount = 0;
+    size_t precipitationCount = 0;
+    size_t temperatureCount = 0;
+    size_t windCount = 0;
+    size_t codeCount = 0;
+
+protected:
+    bool onNumber(double value) override {
+        // current_weather.<field>
+        if (path.size() == 2 && keyIs(0, "current_weather")) {
+            if (keyIs(1, "temperature")) { out.temperature = value; haveTemperature = true; }
+            else if (keyIs(1, "weathercode")) { out.weathercode = static_cast<int>(value); haveCode = true; }
+            else if (keyIs(1, "windspeed")) { out.windspeed = value; haveWind = true; }
+            return true;
+        }
+        storeHourly(static_cast<float>(value));
+        return true;
+    }
+
+    bool onNull() override {
+        storeHourly(std::numeric_limits<float>::quiet_NaN()); // Gaps in the series
+        return true;
+    }
+
+    bool onString(const std::string& value) override {
+        if (path.size() == 3 && keyIs(0, "hourly") && keyIs(1, "time") && path[2].index == 0) {
+            out.hourly.startTime = parseLocalHour(value);
+        }
+        return true;
+    }
+
+private:
+    WeatherData& out;
+
+    // hourly.<series>[index]
+    void storeHourly(float value) {
+        if (path.size() != 3 || !keyIs(0, "hourly") || !path[2].isArray) return;
+        const size_t index = path[2].index;
+        if (index >= static_cast<size_t>(HourlyForecast::CAPACITY)) return;
+
+        if (keyIs(1, "apparent_temperature")) {
+            out.hourly.apparentTemperature[index] = value;
+            apparentCount = std::max(apparentCount, index + 1);
+        } else if (keyIs(1, "precipitation")) {
+            out.hourly.precipitation[index] = value;
+            precipitationCount = std::max(precipitationCount, index + 1);
+        } else if (keyIs(1, "temperature_2m")) {
+            out.hourly.temperature[index] = value;
+            temperatureCount = std::max(temperatureCount, index + 1);
+        } else if (keyIs(1, "windspeed_10m")) {
+            out.hourly.windspeed[index] = value;
+            windCount = std::max(windCount, index + 1);
+        } else if (keyIs(1, "weathercode")) {
+            out.hourly.weathercode[index] = std::isnan(value) ? -1 : static_cast<int>(value);
+            codeCount = std::max(codeCount, index + 1);
+        }
+    }
+};
+
+class FeedUrlSax : public PathSax {
+public:
+    std::string url;
+    bool found = false;
+
+protected:
+    bool onString(const std::string& value) override {
+        // [0].fullUrl
+        if (path.size() == 2 && path[0].isArray && path[0].index == 0 && keyIs(1, "fullUrl")) {
+            url = value;
+            found = true;
+            return false; // Nothing else needed; stop reading
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+bool extractWeather(const std::string& body, WeatherData& out, std::string& error) {
+    WeatherData parsed;
+    WeatherSax sax(parsed);
+    if (!json::sax_parse(body, &sax)) {
+        error = sax.error.empty() ? "malformed weather JSON" : sax.error;
+        return false;
+    }
+    if (!sax.haveTemperature || !sax.haveCode || !sax.haveWind) {
+        error = "current_weather is missing temperature, weathercode or windspeed";
+        return false;
+    }
+
+    parsed.hourly.count = static_cast<int>(std::min(sax.apparentCount, sax.precipitationCount));
+    parsed.hourly.conditionsCount = static_cast<int>(std::min({sax.temperatureCount, sax.windCount, sax.codeCount}));
+    out = parsed;
+    return true;
+}
+
+bool extractFirstFeedUrl(const std::string& body, std::string& url, std::string& error) {
+    FeedUrlSax sax;
+    json::sax_parse(body, &sax); // Returns false when we stop early
+    if (!sax.found) {
+        error = sax.error.empty() ? "feed has no data[0].fullUrl" : sax.error;
+        return false;
+    }
+    url = std::move(sax.url);
+    return true;
+}
@@ -0,0 +1,22 @@
+// json_extract.h
+#ifndef JSON_EXTRACT_H
+#define JSON_EXTRACT_H
+
+#include "weather_api.h"
+#include <string>
+
+// Streaming extraction of the few fields we use from API responses. Both run
+// nlohmann's SAX parser without building a DOM, so memory stays bounded
+// regardless of response size.
+
+// current_weather.{temperature,weathercode,windspeed} plus the first
+// HourlyForecast::CAPACITY entries of hourly.{time,apparent_temperature,precipitation}
+// and hourly.{temperature_2m,weathercode,windspeed_10m}. The request limits the
+// series to the prefetch window with forecast_hours.
+// Returns false (with error set) on malformed JSON or missing current_weather fields.
+bool extractWeather(const std::string& body, WeatherData& out, std::string& error);
+
+// data[0].fullUrl from the background feed; parsing stops as soon as it is found
+bool extractFirstFeedUrl(const std::string& body, std::string& url, std::string& error);
+
+#endif // JSON_EXTRACT_H
@@ -1,69 +1,213 @@
 #include "logger.h"
-#include <iostream>
 #include <cstdarg>
 #include <cstdio>
-#include <ctime>
 #include <cstring>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
-#include <sys/stat.h>
 #include <unistd.h>
 #include <thread>
 #include <fstream>
 #include <functional>
 #include <string>
 
+constexpr size_t Logger::RING_CAPACITY;
+constexpr size_t Logger::MESSAGE_BYTES;
+
 Logger& Logger::instance() {
     static Logger instance;
     return instance;
 }
 
+Logger::Logger() : ring(new Record[RING_CAPACITY]) {
+    static_assert((RING_CAPACITY & (RING_CAPACITY - 1)) == 0, "RING_CAPACITY must be a power of two");
+    for (size_t i = 0; i < RING_CAPACITY; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    running = true;
+    writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running = false;
+    }
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join(); // Drains whatever is left
+    }
+    delete[] ring;
+    ring = nullptr;
+}
+
 void Logger::log(Level level, const char* file, int line, const char* format, ...) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    
-    // Format the message using variadic arguments
-    char buffer[4096];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+
+    if (!running) {
+        // Before the writer starts or after it is gone (static destruction)
+        char buffer[MESSAGE_BYTES];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        writeDirect(level, file, line, buffer);
+        return;
+    }
+
+    // Claim a slot (bounded MPSC ring, one sequence number per slot)
+    const uint64_t mask = RING_CAPACITY - 1;
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Record* record;
+    for (;;) {
+        record = &ring[pos & mask];
+        uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Full: drop rather than stall the render thread behind the writer
+            va_end(args);
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->level = level;
+    record->line = line;
+    record->file = file;
+    record->threadId = getThreadId();
+    int length = vsnprintf(record->message, MESSAGE_BYTES, format, args);
     va_end(args);
-    
-    // Build log entry without timestamp (systemd provides it)
-    std::ostringstream logEntry;
-    logEntry << "[" << getLevelString(level) << "] "
-             << "[Thread:" << getThreadId() << "] "
-             << "[" << file << ":" << line << "] "
-             << buffer << std::endl;
-    
-    // Route ERROR and CRITICAL to stderr, others to stdout
-    if (level >= ERROR) {
-        std::cerr << logEntry.str() << std::flush;
+    if (length >= static_cast<int>(MESSAGE_BYTES)) {
+        std::memcpy(record->message + MESSAGE_BYTES - 4, "...", 4);
+    }
+    record->sequence.store(pos + 1, std::memory_order_release);
+
+    if (level >= ERROR || writerWaiting.load()) {
+        wake.notify_one();
+    }
+    if (level == CRITICAL) {
+        flush(); // Usually followed by an exit; make sure it reaches the journal
+    }
+}
+
+void Logger::flush() {
+    if (!running) {
+        return;
+    }
+    const uint64_t target = enqueuePos.load();
+    wake.notify_one();
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    written.wait_for(lock, std::chrono::seconds(1), [this, target]() { return writtenPos.load() >= target; });
+}
+
+size_t Logger::drainBatch(std::string& out, std::string& err) {
+    static constexpr size_t MAX_BATCH = 64;
+    const uint64_t mask = RING_CAPACITY - 1;
+    size_t count = 0;
+    while (count < MAX_BATCH) {
+        Record& record = ring[dequeuePos & mask];
+        if (record.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break; // Empty, or the producer is still formatting this slot
+        }
+        // Route ERROR and CRITICAL to stderr, others to stdout
+        appendRecord(record.level >= ERROR ? err : out, record);
+        record.sequence.store(dequeuePos + RING_CAPACITY, std::memory_order_release);
+        ++dequeuePos;
+        ++count;
+    }
+    return count;
+}
+
+void Logger::appendRecord(std::string& buffer, const Record& record) {
+    // No timestamp (systemd provides it)
+    char prefix[160];
+    if (record.line > 0) {
+        snprintf(prefix, sizeof(prefix), "[%s] [Thread:%lu] [%s:%d] ",
+                 getLevelString(record.level), record.threadId, record.file, record.line);
+    } else {
+        snprintf(prefix, sizeof(prefix), "[%s] [Thread:%lu] [%s] ",
+                 getLevelString(record.level), record.threadId, record.file);
+    }
+    buffer += prefix;
+    buffer += record.message;
+    buffer += '\n';
+}
+
+void Logger::writerLoop() {
+    std::string out;
+    std::string err;
+    out.reserve(16 * 1024);
+    err.reserve(4 * 1024);
+
+    for (;;) {
+        out.clear();
+        err.clear();
+        size_t count = drainBatch(out, err);
+
+        uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+        if (droppedNow != droppedReported) {
+            char line[128];
+            snprintf(line, sizeof(line), "[WARNING] [logger] Dropped %llu messages (ring full)\n",
+                     static_cast<unsigned long long>(droppedNow - droppedReported));
+            out += line;
+            droppedReported = droppedNow;
+        }
+
+        // One write per stream per batch
+        if (!out.empty()) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            fflush(stdout);
+        }
+        if (!err.empty()) {
+            fwrite(err.data(), 1, err.size(), stderr);
+            fflush(stderr);
+        }
+
+        if (count > 0) {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                writtenPos.store(dequeuePos);
+            }
+            written.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (!running) {
+            break; // Ring is empty and nothing more is coming
+        }
+        writerWaiting = true;
+        // The timeout covers a notify that races with going to sleep
+        wake.wait_for(lock, std::chrono::milliseconds(200), [this]() {
+            return !running || ring[dequeuePos & (RING_CAPACITY - 1)].sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+        });
+        writerWaiting = false;
+    }
+}
+
+void Logger::writeDirect(Level level, const char* file, int line, const char* message) {
+    std::FILE* stream = level >= ERROR ? stderr : stdout;
+    if (line > 0) {
+        fprintf(stream, "[%s] [Thread:%lu] [%s:%d] %s\n", getLevelString(level), getThreadId(), file, line, message);
     } else {
-        std::cout << logEntry.str() << std::flush;
+        fprintf(stream, "[%s] [Thread:%lu] [%s] %s\n", getLevelString(level), getThreadId(), file, message);
     }
+    fflush(stream);
 }
 
 void Logger::logMemoryUsage() {
-    std::lock_guard<std::mutex> lock(logMutex);
-    
     size_t memoryKB = getMemoryUsageKB();
-    
-    std::ostringstream logEntry;
-    logEntry << "[INFO] "
-             << "[Thread:" << getThreadId() << "] "
-             << "[memory] "
-             << "RSS: " << memoryKB << " KB ("
-             << (memoryKB / 1024.0) << " MB)" << std::endl;
-    
-    std::cout << logEntry.str() << std::flush;
+    log(INFO, "memory", 0, "RSS: %zu KB (%.1f MB)", memoryKB, memoryKB / 1024.0);
 }
 
 std::string Logger::getFormattedMemoryUsage() {
     size_t memoryKB = getMemoryUsageKB();
-    std::ostringstream oss;
-    oss << memoryKB << " KB (" << (memoryKB / 1024.0) << " MB)";
-    return oss.str();
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%zu KB (%.1f MB)", memoryKB, memoryKB / 1024.0);
+    return buffer;
 }
 
 size_t Logger::getMemoryUsageKB() {
@@ -83,7 +227,7 @@ size_t Logger::getMemoryUsageKB() {
     return (resident * pageSize) / 1024;
 }
 
-std::string Logger::getLevelString(Level level) {
+const char* Logger::getLevelString(Level level) {
     switch (level) {
         case DEBUG:    return "DEBUG";
         case INFO:     return "INFO";
@@ -95,5 +239,6 @@ std::string Logger::getLevelString(Level level) {
 }
 
 unsigned long Logger::getThreadId() {
-    return std::hash<std::thread::id>{}(std::this_thread::get_id());
-}
\ No newline at end of file
+    static thread_local unsigned long id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return id;
+}
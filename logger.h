@@ -3,7 +3,18 @@
 
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
 #include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+// Messages below this level compile to nothing (0 = DEBUG ... 4 = CRITICAL).
+// Set from CMake with -DLOG_MIN_LEVEL=<n>.
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 1
+#endif
 
 class Logger {
 public:
@@ -18,8 +29,17 @@ public:
     // Singleton access
     static Logger& instance();
 
-    // Main logging function
-    void log(Level level, const char* file, int line, const char* format, ...);
+    // Main logging function. Formats the message into a ring slot and returns;
+    // a background thread adds the prefix and writes records in batches.
+    // CRITICAL waits until its record has been written.
+    void log(Level level, const char* file, int line, const char* format, ...)
+        __attribute__((format(printf, 5, 6)));
+
+    // Block until everything logged so far has been written
+    void flush();
+
+    // Messages discarded because the ring was full
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
 
     // Log memory usage from /proc/self/statm
     void logMemoryUsage();
@@ -27,28 +47,63 @@ public:
     // Get formatted memory usage string
     std::string getFormattedMemoryUsage();
 
+    // Resident set size from /proc/self/statm
+    size_t getMemoryUsageKB();
+
     // Prevent copying
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
 private:
-    Logger() = default;
-    ~Logger() = default;
+    Logger();
+    ~Logger();
 
-    // Thread-safe console operations
-    std::mutex logMutex;
+    static constexpr size_t RING_CAPACITY = 512;   // Slots; must be a power of two
+    static constexpr size_t MESSAGE_BYTES = 480;   // Longer messages are truncated
+
+    struct Record {
+        std::atomic<uint64_t> sequence; // Slot state for the MPSC ring
+        Level level;
+        int line;
+        const char* file;               // __FILE__ literal, never freed
+        unsigned long threadId;
+        char message[MESSAGE_BYTES];
+    };
+
+    Record* ring;
+    std::atomic<uint64_t> enqueuePos{0};
+    uint64_t dequeuePos = 0;                  // Writer thread only
+    std::atomic<uint64_t> writtenPos{0};      // Records fully written, for flush()
+    std::atomic<uint64_t> dropped{0};
+    uint64_t droppedReported = 0;             // Writer thread only
+
+    std::thread writer;
+    std::atomic<bool> running{false};
+    std::atomic<bool> writerWaiting{false};
+    std::mutex wakeMutex;                     // Only taken to sleep, never by log()
+    std::condition_variable wake;
+    std::condition_variable written;
 
     // Internal methods
-    size_t getMemoryUsageKB();
-    std::string getLevelString(Level level);
-    unsigned long getThreadId();
+    void writerLoop();
+    size_t drainBatch(std::string& out, std::string& err);
+    void appendRecord(std::string& buffer, const Record& record);
+    void writeDirect(Level level, const char* file, int line, const char* message);
+    static const char* getLevelString(Level level);
+    static unsigned long getThreadId();
 };
 
-// Convenience macros for easy logging
-#define LOG_DEBUG(...) Logger::instance().log(Logger::DEBUG, __FILE__, __LINE__, __VA_ARGS__)
-#define LOG_INFO(...) Logger::instance().log(Logger::INFO, __FILE__, __LINE__, __VA_ARGS__)
-#define LOG_WARNING(...) Logger::instance().log(Logger::WARNING, __FILE__, __LINE__, __VA_ARGS__)
-#define LOG_ERROR(...) Logger::instance().log(Logger::ERROR, __FILE__, __LINE__, __VA_ARGS__)
-#define LOG_CRITICAL(...) Logger::instance().log(Logger::CRITICAL, __FILE__, __LINE__, __VA_ARGS__)
+// Convenience macros for easy logging. Arguments are not evaluated when the
+// level is compiled out.
+#define LOG_AT_LEVEL(level, ...) \
+    do { \
+        if ((level) >= LOG_MIN_LEVEL) Logger::instance().log((level), __FILE__, __LINE__, __VA_ARGS__); \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT_LEVEL(Logger::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT_LEVEL(Logger::INFO, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT_LEVEL(Logger::WARNING, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT_LEVEL(Logger::ERROR, __VA_ARGS__)
+#define LOG_CRITICAL(...) LOG_AT_LEVEL(Logger::CRITICAL, __VA_ARGS__)
 
-#endif // LOGGER_H
\ No newline at end of file
+#endif // LOGGER_H
@@ -1,19 +1,81 @@
 // main.cpp
 #include "clock.h"
 #include "logger.h"
+#include "render_backend.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <unistd.h>
 #include "version.h"
 
-int main() {
+namespace {
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Usage: %s [--size WxH] [--backend sdl|kmsdrm]\n"
+        "          [--headless [--frames N] [--seed N] [--fixtures DIR] [--report FILE] [--budget-ms MS]]\n",
+        program);
+}
+
+// Returns false on unknown or malformed arguments
+bool parseOptions(int argc, char** argv, ClockOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(arg, "--size") == 0 && value) {
+            if (std::sscanf(value, "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                return false;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--backend") == 0 && value) {
+            if (!parseRenderBackend(value, options.backend)) {
+                return false;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--frames") == 0 && value) {
+            options.frames = std::atoi(value);
+            ++i;
+        } else if (std::strcmp(arg, "--seed") == 0 && value) {
+            options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            ++i;
+        } else if (std::strcmp(arg, "--fixtures") == 0 && value) {
+            options.fixtureDir = value;
+            ++i;
+        } else if (std::strcmp(arg, "--report") == 0 && value) {
+            options.reportPath = value;
+            ++i;
+        } else if (std::strcmp(arg, "--budget-ms") == 0 && value) {
+            options.frameBudgetMs = std::atof(value);
+            ++i;
+        } else {
+            return false;
+        }
+    }
+    return options.frames > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ClockOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
     LOG_INFO("Application starting...");
     LOG_INFO("Version: %s (built %s)", VERSION_GIT_HASH, VERSION_BUILD_TIME);
     LOG_INFO("Process ID: %d", getpid());
     Logger::instance().logMemoryUsage();
     
+    int status = 0;
     try {
-        Clock clock;
+        Clock clock(options);
         LOG_INFO("Clock initialized successfully");
-        clock.run();
+        status = clock.run();
         LOG_INFO("Clock run() completed normally");
     } catch (const std::exception& e) {
         LOG_CRITICAL("Fatal exception in main: %s", e.what());
@@ -26,5 +88,5 @@ int main() {
     LOG_INFO("Application shutting down normally");
     Logger::instance().logMemoryUsage();
     
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
@@ -0,0 +1,108 @@
+// memory_budget.cpp
+#include "memory_budget.h"
+#include "logger.h"
+#include <cstdio>
+#include <string>
+
+constexpr size_t MemoryBudget::POOLS;
+constexpr size_t MemoryBudget::KINDS;
+
+namespace {
+
+double toMB(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+MemoryBudget& MemoryBudget::instance() {
+    static MemoryBudget instance;
+    return instance;
+}
+
+const char* MemoryBudget::poolName(MemoryPool pool) {
+    switch (pool) {
+        case MemoryPool::TEXT_CACHE:   return "text";
+        case MemoryPool::BACKGROUND:   return "background";
+        case MemoryPool::SNOW:         return "snow";
+        case MemoryPool::RENDER_LAYER: return "layer";
+        case MemoryPool::HTTP:         return "http";
+        default:                       return "?";
+    }
+}
+
+void MemoryBudget::adjust(MemoryPool pool, MemoryKind kind, int64_t delta) {
+    bytes[static_cast<size_t>(pool)][static_cast<size_t>(kind)].fetch_add(delta, std::memory_order_relaxed);
+    const int64_t now = totalBytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (delta > 0) {
+        size_t seen = peakBytes.load(std::memory_order_relaxed);
+        while (static_cast<size_t>(now) > seen &&
+               !peakBytes.compare_exchange_weak(seen, static_cast<size_t>(now), std::memory_order_relaxed)) {
+        }
+    }
+}
+
+size_t MemoryBudget::usage(MemoryPool pool, MemoryKind kind) const {
+    int64_t value = bytes[static_cast<size_t>(pool)][static_cast<size_t>(kind)].load(std::memory_order_relaxed);
+    return value > 0 ? static_cast<size_t>(value) : 0;
+}
+
+size_t MemoryBudget::usage(MemoryPool pool) const {
+    return usage(pool, MemoryKind::CPU) + usage(pool, MemoryKind::GPU);
+}
+
+size_t MemoryBudget::total() const {
+    int64_t value = totalBytes.load(std::memory_order_relaxed);
+    return value > 0 ? static_cast<size_t>(value) : 0;
+}
+
+size_t MemoryBudget::availableFor(MemoryPool pool) const {
+    const size_t limit = getLimit();
+    if (limit == 0) {
+        return SIZE_MAX;
+    }
+    const size_t own = usage(pool);
+    const size_t others = total() > own ? total() - own : 0;
+    return limit > others ? limit - others : 0;
+}
+
+void MemoryBudget::logStatus() const {
+    // "text 1.2+8.0" = CPU+GPU MB per pool
+    std::string pools;
+    for (size_t i = 0; i < POOLS; ++i) {
+        MemoryPool pool = static_cast<MemoryPool>(i);
+        char part[64];
+        std::snprintf(part, sizeof(part), "%s%s %.1f+%.1f", i ? ", " : "", poolName(pool),
+                      toMB(usage(pool, MemoryKind::CPU)), toMB(usage(pool, MemoryKind::GPU)));
+        pools += part;
+    }
+
+    const size_t used = total();
+    const size_t limit = getLimit();
+    LOG_INFO("Memory budget: %.1f/%.1f MB, peak %.1f MB (CPU+GPU MB: %s)",
+             toMB(used), toMB(limit), toMB(peak()), pools.c_str());
+    if (limit > 0 && used > limit) {
+        LOG_WARNING("Memory budget exceeded by %.1f MB", toMB(used - limit));
+    }
+}
+
+MemoryCharge::MemoryCharge(MemoryPool pool, MemoryKind kind, size_t bytes)
+    : pool(pool), kind(kind), current(0)
+{
+    resize(bytes);
+}
+
+MemoryCharge::~MemoryCharge() {
+    release();
+}
+
+void MemoryCharge::resize(size_t newBytes) {
+    if (newBytes != current) {
+        MemoryBudget::instance().adjust(pool, kind, static_cast<int64_t>(newBytes) - static_cast<int64_t>(current));
+        current = newBytes;
+    }
+}
+
+size_t surfaceBytes(const SDL_Surface* surface) {
+    return surface ? static_cast<size_t>(surface->pitch) * surface->h : 0;
+}
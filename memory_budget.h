@@ -0,0 +1,93 @@
+// memory_budget.h
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Subsystems whose memory is accounted
+enum class MemoryPool {
+    TEXT_CACHE,     // String textures and glyph atlases
+    BACKGROUND,     // Decoded images and their streaming textures
+    SNOW,           // Particle arrays and the sprite atlas
+    RENDER_LAYER,   // Cached text layer target
+    HTTP,           // Response bodies being received or decoded
+    COUNT
+};
+
+enum class MemoryKind {
+    CPU,   // Heap and SDL surfaces
+    GPU,   // Texture memory (estimated as width * height * 4)
+    COUNT
+};
+
+// Process-wide byte accounting against one global limit. Subsystems hold a
+// MemoryCharge for what they keep resident; the text cache, the only elastic
+// consumer, evicts down to availableFor(TEXT_CACHE). Counters are relaxed
+// atomics, so any thread can charge without locking.
+class MemoryBudget {
+public:
+    static MemoryBudget& instance();
+
+    void setLimit(size_t bytes) { limitBytes.store(bytes, std::memory_order_relaxed); }
+    size_t getLimit() const { return limitBytes.load(std::memory_order_relaxed); }
+
+    size_t usage(MemoryPool pool, MemoryKind kind) const;
+    size_t usage(MemoryPool pool) const;   // CPU + GPU
+    size_t total() const;
+    size_t peak() const { return peakBytes.load(std::memory_order_relaxed); }
+
+    // What pool may hold without taking the total over the limit, given
+    // what every other pool holds right now
+    size_t availableFor(MemoryPool pool) const;
+
+    // Heartbeat line per pool; warns when the total is over the limit
+    void logStatus() const;
+
+    static const char* poolName(MemoryPool pool);
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+private:
+    friend class MemoryCharge;
+
+    MemoryBudget() = default;
+    void adjust(MemoryPool pool, MemoryKind kind, int64_t delta);
+
+    static constexpr size_t POOLS = static_cast<size_t>(MemoryPool::COUNT);
+    static constexpr size_t KINDS = static_cast<size_t>(MemoryKind::COUNT);
+
+    std::atomic<int64_t> bytes[POOLS][KINDS] = {};
+    std::atomic<int64_t> totalBytes{0};
+    std::atomic<size_t> peakBytes{0};
+    std::atomic<size_t> limitBytes{0};   // 0 = unlimited
+};
+
+// Bytes one owner holds in a pool; released on destruction. Not thread-safe
+// itself: each charge belongs to one owner (the budget counters are).
+class MemoryCharge {
+public:
+    MemoryCharge(MemoryPool pool, MemoryKind kind, size_t bytes = 0);
+    ~MemoryCharge();
+
+    void resize(size_t newBytes);
+    void add(size_t delta) { resize(current + delta); }
+    void release() { resize(0); }
+    size_t bytes() const { return current; }
+
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+private:
+    MemoryPool pool;
+    MemoryKind kind;
+    size_t current;
+};
+
+// CPU bytes of a surface's pixel buffer (0 for nullptr)
+size_t surfaceBytes(const SDL_Surface* surface);
+
+#endif // MEMORY_BUDGET_H
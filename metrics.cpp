@@ -0,0 +1,215 @@
+// metrics.cpp
+#include "metrics.h"
+#include "background_manager.h"
+#include "config.h"
+#include "display.h"
+#include "frame_profiler.h"
+#include "http_client.h"
+#include "logger.h"
+#include <httplib.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <initializer_list>
+
+namespace {
+
+// Request latency bucket bounds (seconds); the last bucket is +Inf
+const double REQUEST_BOUNDS[] = {0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+
+// Frame phase bounds (seconds), coarser than the profiler's own buckets
+const double FRAME_BOUNDS[] = {0.001, 0.002, 0.004, 0.008, 0.0167, 0.0333, 0.05, 0.1, 0.25, 1.0};
+
+const char* requestName(RequestKind kind) {
+    switch (kind) {
+        case RequestKind::WEATHER:          return "weather";
+        case RequestKind::BACKGROUND_FEED:  return "background_feed";
+        case RequestKind::BACKGROUND_IMAGE: return "background_image";
+        case RequestKind::ADVICE:           return "advice";
+        default:                            return "unknown";
+    }
+}
+
+uint64_t load(const std::atomic<uint64_t>& value) {
+    return value.load(std::memory_order_relaxed);
+}
+
+void appendf(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+void appendf(std::string& out, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length > 0) {
+        out.append(line, std::min<size_t>(static_cast<size_t>(length), sizeof(line) - 1));
+    }
+}
+
+void appendHeader(std::string& out, const char* name, const char* type, const char* help) {
+    appendf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+} // namespace
+
+constexpr size_t Metrics::REQUEST_BUCKETS;
+
+Metrics& Metrics::instance() {
+    static Metrics instance;
+    return instance;
+}
+
+void Metrics::recordRequest(RequestKind kind, std::chrono::steady_clock::duration elapsed, bool success) {
+    static_assert(sizeof(REQUEST_BOUNDS) / sizeof(REQUEST_BOUNDS[0]) == REQUEST_BUCKETS, "bucket bounds");
+
+    RequestStats& stats = requests[static_cast<size_t>(kind)];
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    size_t bucket = 0;
+    while (bucket < REQUEST_BUCKETS && seconds > REQUEST_BOUNDS[bucket]) {
+        ++bucket;
+    }
+    stats.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.sumMicros.fetch_add(static_cast<uint64_t>(seconds * 1e6), std::memory_order_relaxed);
+    if (!success) {
+        stats.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::publishTextCache(const TextCacheStats& stats) {
+    textCacheBytes.store(stats.residentBytes, std::memory_order_relaxed);
+    textCacheBudget.store(stats.budgetBytes, std::memory_order_relaxed);
+    textCacheEntries.store(stats.entries, std::memory_order_relaxed);
+    textCacheHits.store(stats.hits, std::memory_order_relaxed);
+    textCacheMisses.store(stats.misses, std::memory_order_relaxed);
+    textCacheEvictions.store(stats.evictions, std::memory_order_relaxed);
+}
+
+std::string Metrics::render(const FrameProfiler* profiler, const BackgroundManager* background) const {
+    std::string out;
+    out.reserve(8 * 1024);
+
+    if (profiler) {
+        appendHeader(out, "clock_frame_phase_seconds", "histogram", "Time spent in each frame phase");
+        for (size_t p = 0; p < static_cast<size_t>(FramePhase::COUNT); ++p) {
+            const FramePhase phase = static_cast<FramePhase>(p);
+            const DurationHistogram& hist = profiler->histogram(phase);
+            const char* name = FrameProfiler::phaseName(phase);
+
+            // Each fine bucket is counted under the first bound that covers all of it
+            uint64_t cumulative = 0;
+            size_t fine = 0;
+            for (double bound : FRAME_BOUNDS) {
+                const uint32_t boundMicros = static_cast<uint32_t>(bound * 1e6);
+                while (fine < DurationHistogram::BUCKETS && DurationHistogram::bucketUpperBound(fine) <= boundMicros) {
+                    cumulative += hist.bucketCount(fine++);
+                }
+                appendf(out, "clock_frame_phase_seconds_bucket{phase=\"%s\",le=\"%g\"} %llu\n",
+                        name, bound, static_cast<unsigned long long>(cumulative));
+            }
+            while (fine < DurationHistogram::BUCKETS) {
+                cumulative += hist.bucketCount(fine++);
+            }
+            appendf(out, "clock_frame_phase_seconds_bucket{phase=\"%s\",le=\"+Inf\"} %llu\n",
+                    name, static_cast<unsigned long long>(cumulative));
+            appendf(out, "clock_frame_phase_seconds_sum{phase=\"%s\"} %.6f\n", name, hist.sumMicros() / 1e6);
+            appendf(out, "clock_frame_phase_seconds_count{phase=\"%s\"} %llu\n",
+                    name, static_cast<unsigned long long>(cumulative));
+        }
+
+        appendHeader(out, "clock_missed_vsyncs_total", "counter", "Refreshes without a new frame in full-rate mode");
+        appendf(out, "clock_missed_vsyncs_total %llu\n", static_cast<unsigned long long>(profiler->missedVsyncs()));
+    }
+
+    appendHeader(out, "clock_text_cache_bytes", "gauge", "Bytes held by cached text textures");
+    appendf(out, "clock_text_cache_bytes %llu\n", static_cast<unsigned long long>(load(textCacheBytes)));
+    appendHeader(out, "clock_text_cache_budget_bytes", "gauge", "Text texture cache budget");
+    appendf(out, "clock_text_cache_budget_bytes %llu\n", static_cast<unsigned long long>(load(textCacheBudget)));
+    appendHeader(out, "clock_text_cache_entries", "gauge", "Cached text textures");
+    appendf(out, "clock_text_cache_entries %llu\n", static_cast<unsigned long long>(load(textCacheEntries)));
+    appendHeader(out, "clock_text_cache_hits_total", "counter", "Text texture cache hits");
+    appendf(out, "clock_text_cache_hits_total %llu\n", static_cast<unsigned long long>(load(textCacheHits)));
+    appendHeader(out, "clock_text_cache_misses_total", "counter", "Text texture cache misses");
+    appendf(out, "clock_text_cache_misses_total %llu\n", static_cast<unsigned long long>(load(textCacheMisses)));
+    appendHeader(out, "clock_text_cache_evictions_total", "counter", "Text textures evicted to stay within budget");
+    appendf(out, "clock_text_cache_evictions_total %llu\n", static_cast<unsigned long long>(load(textCacheEvictions)));
+
+    appendHeader(out, "clock_request_duration_seconds", "histogram", "Network request latency");
+    for (size_t k = 0; k < static_cast<size_t>(RequestKind::COUNT); ++k) {
+        const RequestStats& stats = requests[k];
+        const char* name = requestName(static_cast<RequestKind>(k));
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < REQUEST_BUCKETS; ++b) {
+            cumulative += load(stats.buckets[b]);
+            appendf(out, "clock_request_duration_seconds_bucket{request=\"%s\",le=\"%g\"} %llu\n",
+                    name, REQUEST_BOUNDS[b], static_cast<unsigned long long>(cumulative));
+        }
+        cumulative += load(stats.buckets[REQUEST_BUCKETS]);
+        appendf(out, "clock_request_duration_seconds_bucket{request=\"%s\",le=\"+Inf\"} %llu\n",
+                name, static_cast<unsigned long long>(cumulative));
+        appendf(out, "clock_request_duration_seconds_sum{request=\"%s\"} %.6f\n", name, load(stats.sumMicros) / 1e6);
+        appendf(out, "clock_request_duration_seconds_count{request=\"%s\"} %llu\n",
+                name, static_cast<unsigned long long>(cumulative));
+    }
+    appendHeader(out, "clock_request_failures_total", "counter", "Failed network requests");
+    for (size_t k = 0; k < static_cast<size_t>(RequestKind::COUNT); ++k) {
+        appendf(out, "clock_request_failures_total{request=\"%s\"} %llu\n",
+                requestName(static_cast<RequestKind>(k)), static_cast<unsigned long long>(load(requests[k].failures)));
+    }
+
+    appendHeader(out, "clock_http_circuit_state", "gauge", "Circuit breaker state per host (1 for the current state)");
+    for (const auto& circuit : HTTPClient::circuitStates()) {
+        for (const char* state : {"CLOSED", "OPEN", "HALF_OPEN"}) {
+            appendf(out, "clock_http_circuit_state{host=\"%s\",state=\"%s\"} %d\n",
+                    circuit.first.c_str(), state, circuit.second == state ? 1 : 0);
+        }
+    }
+
+    if (background) {
+        appendHeader(out, "clock_background_consecutive_failures", "gauge", "Background updates failed in a row");
+        appendf(out, "clock_background_consecutive_failures %d\n", background->getConsecutiveFailures());
+    }
+
+    appendHeader(out, "clock_resident_memory_bytes", "gauge", "Resident set size");
+    appendf(out, "clock_resident_memory_bytes %llu\n",
+            static_cast<unsigned long long>(Logger::instance().getMemoryUsageKB()) * 1024ULL);
+    appendHeader(out, "clock_log_dropped_total", "counter", "Log messages dropped because the log ring was full");
+    appendf(out, "clock_log_dropped_total %llu\n", static_cast<unsigned long long>(Logger::instance().droppedCount()));
+
+    return out;
+}
+
+MetricsServer::MetricsServer(int port, const FrameProfiler* profiler, const BackgroundManager* background)
+    : port(port), profiler(profiler), background(background), server(new httplib::Server())
+{
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    // One handler thread is plenty for a scraper every few seconds
+    server->new_task_queue = []() { return new httplib::ThreadPool(1); };
+    server->set_read_timeout(5);
+    server->set_write_timeout(5);
+    server->Get("/metrics", [this](const httplib::Request&, httplib::Response& res) {
+        res.set_content(Metrics::instance().render(profiler, background), "text/plain; version=0.0.4");
+    });
+
+    if (!server->bind_to_port(METRICS_BIND_ADDRESS, port)) {
+        LOG_ERROR("Metrics server could not bind to %s:%d", METRICS_BIND_ADDRESS, port);
+        return false;
+    }
+    thread = std::thread([this]() { server->listen_after_bind(); });
+    LOG_INFO("Metrics server listening on %s:%d/metrics", METRICS_BIND_ADDRESS, port);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (thread.joinable()) {
+        server->stop();
+        thread.join();
+    }
+}
@@ -0,0 +1,86 @@
+// metrics.h
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+struct TextCacheStats;
+class FrameProfiler;
+class BackgroundManager;
+
+namespace httplib { class Server; }
+
+// Network requests tracked for the /metrics endpoint
+enum class RequestKind {
+    WEATHER,
+    BACKGROUND_FEED,
+    BACKGROUND_IMAGE,
+    ADVICE,
+    COUNT
+};
+
+// Process-wide counters. Writers only touch relaxed atomics, so recording
+// from the render thread or a worker never blocks on the metrics reader.
+class Metrics {
+public:
+    static Metrics& instance();
+
+    // Worker threads: one finished request (success includes 304s)
+    void recordRequest(RequestKind kind, std::chrono::steady_clock::duration elapsed, bool success);
+
+    // Render thread: publish a copy of Display's cache counters
+    void publishTextCache(const TextCacheStats& stats);
+
+    // Prometheus text exposition format. Reads the profiler and background
+    // manager (atomics only) if given.
+    std::string render(const FrameProfiler* profiler, const BackgroundManager* background) const;
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+private:
+    Metrics() = default;
+
+    static constexpr size_t REQUEST_BUCKETS = 8; // Upper bounds in REQUEST_BOUNDS, plus +Inf
+
+    struct RequestStats {
+        std::atomic<uint64_t> buckets[REQUEST_BUCKETS + 1] = {};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> sumMicros{0};
+    };
+    RequestStats requests[static_cast<size_t>(RequestKind::COUNT)];
+
+    std::atomic<uint64_t> textCacheBytes{0};
+    std::atomic<uint64_t> textCacheBudget{0};
+    std::atomic<uint64_t> textCacheEntries{0};
+    std::atomic<uint64_t> textCacheHits{0};
+    std::atomic<uint64_t> textCacheMisses{0};
+    std::atomic<uint64_t> textCacheEvictions{0};
+};
+
+// Serves Metrics::render() at GET /metrics from its own thread
+class MetricsServer {
+public:
+    // profiler and background must outlive the server (or be null)
+    MetricsServer(int port, const FrameProfiler* profiler, const BackgroundManager* background);
+    ~MetricsServer();
+
+    bool start();
+    void stop();
+
+private:
+    int port;
+    const FrameProfiler* profiler;
+    const BackgroundManager* background;
+    std::unique_ptr<httplib::Server> server;
+    std::thread thread;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,76 @@
+// quality_governor.cpp
+#include "quality_governor.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstdlib>
+
+constexpr int QualityGovernor::LEVEL_COUNT;
+
+QualityGovernor::QualityGovernor(int refreshRate, int minFlakes, int maxFlakes, int startFlakes)
+    : level(0),
+      lateThreshold(LATE_FACTOR / std::max(refreshRate, 1)),
+      windowFrames(0), windowLate(0), cleanWindows(0),
+      upgradeWindows(INITIAL_UPGRADE_WINDOWS), lastChangeWasUpgrade(false),
+      downgrades(0), upgrades(0) {
+    maxFlakes = std::max(maxFlakes, minFlakes);
+    for (int i = 0; i < LEVEL_COUNT; ++i) {
+        levels[i].flakes = minFlakes + (maxFlakes - minFlakes) * i / (LEVEL_COUNT - 1);
+        // Flake radii are 2-4: the lowest levels rotate only the largest
+        // sprites, the top levels all of them
+        levels[i].rotationMinRadius = i >= 4 ? 2 : (i >= 2 ? 3 : 4);
+        if (std::abs(levels[i].flakes - startFlakes) < std::abs(levels[level].flakes - startFlakes)) {
+            level = i;
+        }
+    }
+}
+
+bool QualityGovernor::recordFrame(float intervalSeconds) {
+    ++windowFrames;
+    if (intervalSeconds > lateThreshold) {
+        ++windowLate;
+    }
+    if (windowFrames < WINDOW_FRAMES) {
+        return false;
+    }
+
+    const int late = windowLate;
+    windowFrames = 0;
+    windowLate = 0;
+
+    if (late > WINDOW_FRAMES * LATE_FRACTION) {
+        cleanWindows = 0;
+        if (level == 0) {
+            return false;
+        }
+        if (lastChangeWasUpgrade) {
+            upgradeWindows = std::min(upgradeWindows * 2, MAX_UPGRADE_WINDOWS);
+        }
+        --level;
+        ++downgrades;
+        lastChangeWasUpgrade = false;
+        LOG_INFO("Snow quality down to level %d (%d of %d frames late): %d flakes",
+                 level, late, WINDOW_FRAMES, levels[level].flakes);
+        return true;
+    }
+
+    if (late > 0) {
+        cleanWindows = 0;
+        return false;
+    }
+
+    if (++cleanWindows < upgradeWindows || level == LEVEL_COUNT - 1) {
+        return false;
+    }
+    cleanWindows = 0;
+    ++level;
+    ++upgrades;
+    lastChangeWasUpgrade = true;
+    LOG_INFO("Snow quality up to level %d: %d flakes", level, levels[level].flakes);
+    return true;
+}
+
+void QualityGovernor::logStatus() const {
+    LOG_INFO("Snow quality: level %d/%d, %d flakes, rotation from radius %d, %llu down, %llu up",
+             level, LEVEL_COUNT - 1, levels[level].flakes, levels[level].rotationMinRadius,
+             static_cast<unsigned long long>(downgrades), static_cast<unsigned long long>(upgrades));
+}
@@ -0,0 +1,60 @@
+// quality_governor.h
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <cstdint>
+
+// What SnowSystem draws at a quality level
+struct SnowQuality {
+    int flakes;              // Active flakes; the least visible ones are dropped first
+    int rotationMinRadius;   // Smaller flakes are drawn unrotated (sprites are round)
+};
+
+// Picks the snow quality level from measured frame intervals, so one build
+// fits the whole fleet. Frames are judged against the display's refresh
+// period; every WINDOW_FRAMES frames:
+//  - more than LATE_FRACTION late frames: drop one level at once
+//  - a clean window (no late frames): count it; after upgradeWindows clean
+//    windows in a row, try one level up
+//  - otherwise: keep the level and restart the clean count
+// An upgrade that is followed by a downgrade doubles upgradeWindows (up to
+// MAX_UPGRADE_WINDOWS), so a device near its limit stops oscillating.
+// Feed it only vsync-paced frames (FrameMode::FULL_RATE). Main thread only.
+class QualityGovernor {
+public:
+    static constexpr int LEVEL_COUNT = 6;
+
+    // Levels interpolate minFlakes..maxFlakes; starts at the level closest to startFlakes
+    QualityGovernor(int refreshRate, int minFlakes, int maxFlakes, int startFlakes);
+
+    // Returns true when the level changed; apply quality() then
+    bool recordFrame(float intervalSeconds);
+
+    int getLevel() const { return level; }
+    const SnowQuality& quality() const { return levels[level]; }
+    uint64_t getDowngrades() const { return downgrades; }
+    uint64_t getUpgrades() const { return upgrades; }
+
+    // One heartbeat line
+    void logStatus() const;
+
+private:
+    static constexpr int WINDOW_FRAMES = 120;
+    static constexpr float LATE_FACTOR = 1.5f;      // Late: interval over 1.5 refresh periods
+    static constexpr float LATE_FRACTION = 0.05f;
+    static constexpr int INITIAL_UPGRADE_WINDOWS = 5;
+    static constexpr int MAX_UPGRADE_WINDOWS = 160;
+
+    SnowQuality levels[LEVEL_COUNT];
+    int level;
+    float lateThreshold;     // Seconds
+    int windowFrames;
+    int windowLate;
+    int cleanWindows;
+    int upgradeWindows;
+    bool lastChangeWasUpgrade;
+    uint64_t downgrades;
+    uint64_t upgrades;
+};
+
+#endif // QUALITY_GOVERNOR_H
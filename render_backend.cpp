@@ -0,0 +1,80 @@
+// render_backend.cpp
+#include "render_backend.h"
+#include "logger.h"
+#include <cstdlib>
+#include <cstring>
+
+const char* renderBackendName(RenderBackend backend) {
+    switch (backend) {
+        case RenderBackend::KMSDRM: return "kmsdrm";
+        case RenderBackend::SDL_DEFAULT:
+        default:                    return "sdl";
+    }
+}
+
+bool parseRenderBackend(const std::string& name, RenderBackend& backend) {
+    if (name == "sdl") {
+        backend = RenderBackend::SDL_DEFAULT;
+    } else if (name == "kmsdrm") {
+        backend = RenderBackend::KMSDRM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool initVideoBackend(RenderBackend& backend) {
+    if (backend == RenderBackend::KMSDRM) {
+        // Overwrite 0: a driver chosen in the environment wins
+        const bool driverFromEnv = std::getenv("SDL_VIDEODRIVER") != nullptr;
+        setenv("SDL_VIDEODRIVER", "kmsdrm", 0);
+
+        if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+            const char* driver = SDL_GetCurrentVideoDriver();
+            if (!driver || std::strcmp(driver, "kmsdrm") != 0) {
+                LOG_INFO("SDL_VIDEODRIVER=%s from the environment overrides the KMS/DRM backend",
+                         driver ? driver : "none");
+                backend = RenderBackend::SDL_DEFAULT;
+                return true;
+            }
+            // GBM/EGL surfaces drawn by the GLES2 renderer. Naming a render
+            // driver turns SDL's command batching off unless it is asked for,
+            // and batching is what folds the snow quads, glyph quads and
+            // background copies into a few draw calls.
+            SDL_SetHintWithPriority(SDL_HINT_RENDER_DRIVER, "opengles2", SDL_HINT_DEFAULT);
+            SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+            // Two buffers instead of three: page flips show a frame one vsync sooner
+            SDL_SetHint(SDL_HINT_VIDEO_DOUBLE_BUFFER, "1");
+            return true;
+        }
+
+        LOG_WARNING("KMS/DRM video init failed (%s), falling back to the default SDL backend", SDL_GetError());
+        if (!driverFromEnv) {
+            unsetenv("SDL_VIDEODRIVER");
+        }
+        backend = RenderBackend::SDL_DEFAULT;
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        LOG_CRITICAL("SDL_Init Error: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+Uint32 backendWindowFlags(RenderBackend backend) {
+    // KMS/DRM has no window manager: the window is the display mode itself
+    return backend == RenderBackend::KMSDRM ? SDL_WINDOW_FULLSCREEN : 0;
+}
+
+void logRenderBackend(SDL_Renderer* renderer, RenderBackend backend) {
+    SDL_RendererInfo info;
+    const char* rendererName = (renderer && SDL_GetRendererInfo(renderer, &info) == 0) ? info.name : "unknown";
+    const char* videoDriver = SDL_GetCurrentVideoDriver();
+    LOG_INFO("Render backend %s: video driver %s, renderer %s", renderBackendName(backend),
+             videoDriver ? videoDriver : "none", rendererName);
+
+    if (backend == RenderBackend::KMSDRM && std::strcmp(rendererName, "opengles2") != 0) {
+        LOG_WARNING("KMS/DRM backend is using the %s renderer, not opengles2", rendererName);
+    }
+}
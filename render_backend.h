@@ -0,0 +1,25 @@
+// render_backend.h
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include "config.h"
+#include <SDL2/SDL.h>
+#include <string>
+
+// "sdl" or "kmsdrm", as accepted by --backend
+const char* renderBackendName(RenderBackend backend);
+bool parseRenderBackend(const std::string& name, RenderBackend& backend);
+
+// SDL_Init(SDL_INIT_VIDEO) for the backend, and the hints its renderer needs.
+// When KMS/DRM cannot start (no DRM device, another process is DRM master,
+// SDL built without it) this falls back to SDL_DEFAULT and updates backend.
+// An SDL_VIDEODRIVER or SDL_RENDER_DRIVER set in the environment wins.
+bool initVideoBackend(RenderBackend& backend);
+
+// Extra SDL_CreateWindow flags for the backend
+Uint32 backendWindowFlags(RenderBackend backend);
+
+// Log the video and render drivers in use; warns if KMS/DRM did not get GLES2
+void logRenderBackend(SDL_Renderer* renderer, RenderBackend backend);
+
+#endif // RENDER_BACKEND_H
@@ -0,0 +1,80 @@
+// render_layer.cpp
+#include "render_layer.h"
+#include "logger.h"
+
+RenderLayer::RenderLayer()
+    : renderer(nullptr), texture(nullptr), previousTarget(nullptr),
+      width(0), height(0), posX(0), posY(0), dirty(true), rebuilds(0),
+      charge(MemoryPool::RENDER_LAYER, MemoryKind::GPU) {
+}
+
+RenderLayer::~RenderLayer() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+}
+
+bool RenderLayer::initialize(SDL_Renderer* renderer, int width, int height) {
+    if (!renderer || !SDL_RenderTargetSupported(renderer)) {
+        LOG_INFO("Render targets not supported; static layers are drawn every frame");
+        return false;
+    }
+
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+    charge.release();
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture) {
+        LOG_WARNING("Failed to create %dx%d layer texture: %s", width, height, SDL_GetError());
+        return false;
+    }
+
+    const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if (SDL_SetTextureBlendMode(texture, premultiplied) != 0) {
+        LOG_DEBUG("Premultiplied blending not supported, compositing layer with SDL_BLENDMODE_BLEND");
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+
+    this->renderer = renderer;
+    this->width = width;
+    this->height = height;
+    dirty = true;
+    charge.resize(getMemoryBytes());
+    return true;
+}
+
+bool RenderLayer::beginRebuild() {
+    if (!texture) {
+        return false;
+    }
+    previousTarget = SDL_GetRenderTarget(renderer);
+    if (SDL_SetRenderTarget(renderer, texture) != 0) {
+        LOG_WARNING("Failed to render into layer texture: %s", SDL_GetError());
+        return false;
+    }
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    return true;
+}
+
+void RenderLayer::endRebuild() {
+    SDL_SetRenderTarget(renderer, previousTarget);
+    previousTarget = nullptr;
+    dirty = false;
+    ++rebuilds;
+}
+
+void RenderLayer::draw() {
+    const SDL_Rect dst = {posX, posY, width, height};
+    if (texture && SDL_RenderCopy(renderer, texture, nullptr, &dst) != 0) {
+        LOG_ERROR("Failed to composite layer texture: %s", SDL_GetError());
+    }
+}
+
+size_t RenderLayer::getMemoryBytes() const {
+    return texture ? static_cast<size_t>(width) * height * 4 : 0;
+}
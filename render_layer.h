@@ -0,0 +1,62 @@
+// render_layer.h
+#ifndef RENDER_LAYER_H
+#define RENDER_LAYER_H
+
+#include "memory_budget.h"
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+
+// Cached off-screen layer: content that rarely changes is rendered once into a
+// transparent SDL_TEXTUREACCESS_TARGET texture, and each frame composites it
+// with a single copy until invalidate() is called.
+//
+// The layer holds premultiplied colour (drawing with SDL_BLENDMODE_BLEND onto
+// transparent black produces that), so it is composited with a custom
+// ONE / ONE_MINUS_SRC_ALPHA blend mode where the renderer supports one.
+// Renderers that do not (the software renderer) get plain alpha blending,
+// which darkens antialiased edges very slightly.
+class RenderLayer {
+public:
+    RenderLayer();
+    ~RenderLayer();
+
+    // Creates the target texture (again, after SDL_RENDER_DEVICE_RESET). Returns
+    // false if the renderer has no render target support; the caller should
+    // then draw the content directly.
+    bool initialize(SDL_Renderer* renderer, int width, int height);
+
+    // Content changed, or the renderer dropped the target's contents
+    // (SDL_RENDER_TARGETS_RESET)
+    void invalidate() { dirty = true; }
+    bool needsRebuild() const { return dirty; }
+
+    // Redirects rendering into the layer, cleared to transparent. Draw the
+    // content, then call endRebuild(). Returns false (rendering untouched) on failure.
+    bool beginRebuild();
+    void endRebuild();
+
+    // Where draw() puts the layer's top-left corner (0, 0 by default). Content
+    // is drawn in layer coordinates during a rebuild.
+    void setPosition(int x, int y) { posX = x; posY = y; }
+
+    // Composite the layer over the current render target
+    void draw();
+
+    uint64_t getRebuildCount() const { return rebuilds; }
+    size_t getMemoryBytes() const;
+
+private:
+    SDL_Renderer* renderer;
+    SDL_Texture* texture;
+    SDL_Texture* previousTarget;   // Restored by endRebuild()
+    int width;
+    int height;
+    int posX;
+    int posY;
+    bool dirty;
+    uint64_t rebuilds;
+    MemoryCharge charge;   // MemoryPool::RENDER_LAYER
+};
+
+#endif // RENDER_LAYER_H
@@ -0,0 +1,278 @@
+// snow_kernel.cpp
+#include "snow_kernel.h"
+#include <algorithm>
+#include <cstring>
+
+#if !defined(SNOW_SCALAR_KERNEL) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define SNOW_KERNEL_NEON 1
+#include <arm_neon.h>
+#elif !defined(SNOW_SCALAR_KERNEL) && (defined(__SSE2__) || defined(_M_X64))
+#define SNOW_KERNEL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+void SnowParticles::resize(size_t count) {
+    x.resize(count);
+    y.resize(count);
+    speed.resize(count);
+    drift.resize(count);
+    angle.resize(count);
+    angleVel.resize(count);
+    boundary.resize(count);
+    depth.resize(count);
+    radius.resize(count);
+}
+
+void SnowParticles::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    speed.reserve(count);
+    drift.reserve(count);
+    angle.reserve(count);
+    angleVel.reserve(count);
+    boundary.reserve(count);
+    depth.reserve(count);
+    radius.reserve(count);
+}
+
+size_t SnowParticles::memoryBytes() const {
+    auto bytes = [](const auto& field) { return field.capacity() * sizeof(field[0]); };
+    return bytes(x) + bytes(y) + bytes(speed) + bytes(drift) + bytes(angle) + bytes(angleVel) +
+           bytes(boundary) + bytes(depth) + bytes(radius);
+}
+
+void SnowRng::seed(uint32_t seed) {
+    // Spread one seed over the lanes with splitmix32; xorshift must never be all-zero
+    for (uint32_t& lane : state) {
+        seed += 0x9E3779B9u;
+        uint32_t z = seed;
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        z ^= z >> 16;
+        lane = z ? z : 0x6D2B79F5u;
+    }
+}
+
+const char* snowKernelName() {
+#if defined(SNOW_KERNEL_NEON)
+    return "NEON";
+#elif defined(SNOW_KERNEL_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+namespace {
+
+inline uint32_t xorshift32(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+// Random bits -> float in [1, 2) by filling the mantissa
+inline float bitsToOneTwo(uint32_t bits) {
+    uint32_t f = (bits >> 9) | 0x3F800000u;
+    float result;
+    std::memcpy(&result, &f, sizeof(result));
+    return result;
+}
+
+inline void updateOne(SnowParticles& p, size_t i, const SnowKernelParams& params, uint32_t& lane) {
+    const float frames = params.frames;
+    const float b = p.boundary[i];
+
+    // Apply gravity
+    p.y[i] += p.speed[i] * frames;
+
+    // Update horizontal drift (random walk in [-driftNoise, driftNoise))
+    float noise = bitsToOneTwo(xorshift32(lane)) * 2.0f - 3.0f;
+    p.drift[i] = std::clamp(p.drift[i] + noise * params.driftNoise, -0.5f, 0.5f);
+    p.x[i] += p.drift[i] * frames;
+
+    // Wrap horizontally
+    if (p.x[i] < -b) {
+        p.x[i] = params.screenWidth + b;
+    } else if (p.x[i] > params.screenWidth + b) {
+        p.x[i] = -b;
+    }
+
+    // Respawn at the top once off the bottom of the screen
+    float spawnX = (bitsToOneTwo(xorshift32(lane)) - 1.0f) * (params.screenWidth + 100.0f) - 50.0f;
+    if (p.y[i] > params.screenHeight + b) {
+        p.x[i] = spawnX;
+        p.y[i] = -b;
+    }
+
+    // Rotate; a single correction suffices since |angleVel * frames| < 360
+    float a = p.angle[i] + p.angleVel[i] * frames;
+    if (a >= 360.0f) {
+        a -= 360.0f;
+    } else if (a < 0.0f) {
+        a += 360.0f;
+    }
+    p.angle[i] = a;
+}
+
+void updateScalar(SnowParticles& p, size_t begin, size_t end, const SnowKernelParams& params, SnowRng& rng) {
+    for (size_t i = begin; i < end; ++i) {
+        updateOne(p, i, params, rng.state[(i - begin) & 3]);
+    }
+}
+
+} // namespace
+
+void updateSnowParticles(SnowParticles& p, size_t begin, size_t end,
+                         const SnowKernelParams& params, SnowRng& rng) {
+    end = std::min(end, p.size());
+    if (begin >= end) {
+        return;
+    }
+
+#if defined(SNOW_KERNEL_SSE2)
+    const size_t vecEnd = begin + ((end - begin) & ~size_t(3));
+
+    const __m128 frames = _mm_set1_ps(params.frames);
+    const __m128 driftNoise = _mm_set1_ps(params.driftNoise);
+    const __m128 width = _mm_set1_ps(params.screenWidth);
+    const __m128 height = _mm_set1_ps(params.screenHeight);
+    const __m128 spawnRange = _mm_set1_ps(params.screenWidth + 100.0f);
+    const __m128 fifty = _mm_set1_ps(50.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+    const __m128 driftMax = _mm_set1_ps(0.5f);
+    const __m128 driftMin = _mm_set1_ps(-0.5f);
+    const __m128 fullTurn = _mm_set1_ps(360.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128i mantissaOne = _mm_set1_epi32(0x3F800000);
+
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rng.state));
+
+    auto next = [&s]() {
+        s = _mm_xor_si128(s, _mm_slli_epi32(s, 13));
+        s = _mm_xor_si128(s, _mm_srli_epi32(s, 17));
+        s = _mm_xor_si128(s, _mm_slli_epi32(s, 5));
+        return s;
+    };
+    auto toOneTwo = [&mantissaOne](__m128i bits) {
+        return _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(bits, 9), mantissaOne));
+    };
+    auto select = [](__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    };
+
+    for (size_t i = begin; i < vecEnd; i += 4) {
+        __m128 x = _mm_loadu_ps(&p.x[i]);
+        __m128 y = _mm_loadu_ps(&p.y[i]);
+        __m128 drift = _mm_loadu_ps(&p.drift[i]);
+        __m128 angle = _mm_loadu_ps(&p.angle[i]);
+        const __m128 b = _mm_loadu_ps(&p.boundary[i]);
+        const __m128 negB = _mm_sub_ps(zero, b);
+
+        y = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(&p.speed[i]), frames));
+
+        __m128 noise = _mm_sub_ps(_mm_mul_ps(toOneTwo(next()), two), three);
+        drift = _mm_add_ps(drift, _mm_mul_ps(noise, driftNoise));
+        drift = _mm_min_ps(_mm_max_ps(drift, driftMin), driftMax);
+        x = _mm_add_ps(x, _mm_mul_ps(drift, frames));
+
+        const __m128 rightEdge = _mm_add_ps(width, b);
+        const __m128 offLeft = _mm_cmplt_ps(x, negB);
+        const __m128 offRight = _mm_cmpgt_ps(x, rightEdge);
+        x = select(offLeft, rightEdge, x);
+        x = select(offRight, negB, x);
+
+        __m128 spawnX = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(toOneTwo(next()), one), spawnRange), fifty);
+        const __m128 offBottom = _mm_cmpgt_ps(y, _mm_add_ps(height, b));
+        x = select(offBottom, spawnX, x);
+        y = select(offBottom, negB, y);
+
+        angle = _mm_add_ps(angle, _mm_mul_ps(_mm_loadu_ps(&p.angleVel[i]), frames));
+        angle = _mm_sub_ps(angle, _mm_and_ps(_mm_cmpge_ps(angle, fullTurn), fullTurn));
+        angle = _mm_add_ps(angle, _mm_and_ps(_mm_cmplt_ps(angle, zero), fullTurn));
+
+        _mm_storeu_ps(&p.x[i], x);
+        _mm_storeu_ps(&p.y[i], y);
+        _mm_storeu_ps(&p.drift[i], drift);
+        _mm_storeu_ps(&p.angle[i], angle);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rng.state), s);
+    updateScalar(p, vecEnd, end, params, rng);
+
+#elif defined(SNOW_KERNEL_NEON)
+    const size_t vecEnd = begin + ((end - begin) & ~size_t(3));
+
+    const float32x4_t frames = vdupq_n_f32(params.frames);
+    const float32x4_t driftNoise = vdupq_n_f32(params.driftNoise);
+    const float32x4_t width = vdupq_n_f32(params.screenWidth);
+    const float32x4_t height = vdupq_n_f32(params.screenHeight);
+    const float32x4_t spawnRange = vdupq_n_f32(params.screenWidth + 100.0f);
+    const float32x4_t fifty = vdupq_n_f32(50.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t two = vdupq_n_f32(2.0f);
+    const float32x4_t three = vdupq_n_f32(3.0f);
+    const float32x4_t driftMax = vdupq_n_f32(0.5f);
+    const float32x4_t driftMin = vdupq_n_f32(-0.5f);
+    const float32x4_t fullTurn = vdupq_n_f32(360.0f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const uint32x4_t mantissaOne = vdupq_n_u32(0x3F800000u);
+
+    uint32x4_t s = vld1q_u32(rng.state);
+
+    auto next = [&s]() {
+        s = veorq_u32(s, vshlq_n_u32(s, 13));
+        s = veorq_u32(s, vshrq_n_u32(s, 17));
+        s = veorq_u32(s, vshlq_n_u32(s, 5));
+        return s;
+    };
+    auto toOneTwo = [&mantissaOne](uint32x4_t bits) {
+        return vreinterpretq_f32_u32(vorrq_u32(vshrq_n_u32(bits, 9), mantissaOne));
+    };
+
+    for (size_t i = begin; i < vecEnd; i += 4) {
+        float32x4_t x = vld1q_f32(&p.x[i]);
+        float32x4_t y = vld1q_f32(&p.y[i]);
+        float32x4_t drift = vld1q_f32(&p.drift[i]);
+        float32x4_t angle = vld1q_f32(&p.angle[i]);
+        const float32x4_t b = vld1q_f32(&p.boundary[i]);
+        const float32x4_t negB = vnegq_f32(b);
+
+        y = vmlaq_f32(y, vld1q_f32(&p.speed[i]), frames);
+
+        float32x4_t noise = vsubq_f32(vmulq_f32(toOneTwo(next()), two), three);
+        drift = vmlaq_f32(drift, noise, driftNoise);
+        drift = vminq_f32(vmaxq_f32(drift, driftMin), driftMax);
+        x = vmlaq_f32(x, drift, frames);
+
+        const float32x4_t rightEdge = vaddq_f32(width, b);
+        const uint32x4_t offLeft = vcltq_f32(x, negB);
+        const uint32x4_t offRight = vcgtq_f32(x, rightEdge);
+        x = vbslq_f32(offLeft, rightEdge, x);
+        x = vbslq_f32(offRight, negB, x);
+
+        float32x4_t spawnX = vsubq_f32(vmulq_f32(vsubq_f32(toOneTwo(next()), one), spawnRange), fifty);
+        const uint32x4_t offBottom = vcgtq_f32(y, vaddq_f32(height, b));
+        x = vbslq_f32(offBottom, spawnX, x);
+        y = vbslq_f32(offBottom, negB, y);
+
+        angle = vmlaq_f32(angle, vld1q_f32(&p.angleVel[i]), frames);
+        angle = vsubq_f32(angle, vbslq_f32(vcgeq_f32(angle, fullTurn), fullTurn, zero));
+        angle = vaddq_f32(angle, vbslq_f32(vcltq_f32(angle, zero), fullTurn, zero));
+
+        vst1q_f32(&p.x[i], x);
+        vst1q_f32(&p.y[i], y);
+        vst1q_f32(&p.drift[i], drift);
+        vst1q_f32(&p.angle[i], angle);
+    }
+
+    vst1q_u32(rng.state, s);
+    updateScalar(p, vecEnd, end, params, rng);
+
+#else
+    updateScalar(p, begin, end, params, rng);
+#endif
+}
@@ -0,0 +1,50 @@
+// snow_kernel.h
+#ifndef SNOW_KERNEL_H
+#define SNOW_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Structure-of-arrays particle store: one contiguous array per field so the
+// update kernel can process four flakes per SIMD instruction
+struct SnowParticles {
+    std::vector<float> x, y;
+    std::vector<float> speed;
+    std::vector<float> drift;
+    std::vector<float> angle;
+    std::vector<float> angleVel;
+    std::vector<float> boundary;    // Off-screen margin: radius * 2 + 50
+    std::vector<float> depth;
+    std::vector<uint8_t> radius;
+
+    size_t size() const { return x.size(); }
+    void resize(size_t count);
+    void reserve(size_t count);
+    size_t memoryBytes() const;   // Allocated bytes over all fields
+};
+
+// Four-lane xorshift32 generator; each lane maps onto one SIMD lane
+struct SnowRng {
+    uint32_t state[4];
+
+    void seed(uint32_t seed);
+};
+
+struct SnowKernelParams {
+    float frames;       // Elapsed time in reference frames
+    float driftNoise;   // Max per-step drift change
+    float screenWidth;
+    float screenHeight;
+};
+
+// Advance flakes [begin, end): gravity, drift random walk, horizontal wrap,
+// respawn at the top and rotation. Uses NEON on ARM, SSE2 on x86 and a scalar
+// loop elsewhere (or when built with SNOW_SCALAR_KERNEL).
+void updateSnowParticles(SnowParticles& particles, size_t begin, size_t end,
+                         const SnowKernelParams& params, SnowRng& rng);
+
+// Name of the compiled-in kernel, for logging
+const char* snowKernelName();
+
+#endif // SNOW_KERNEL_H
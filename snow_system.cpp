@@ -4,30 +4,75 @@
 #include <algorithm>
 #include <cmath>
 
-SnowSystem::SnowSystem(int flakeCount, int screenWidth, int screenHeight)
+constexpr size_t SnowSystem::CHUNK_FLAKES;
+constexpr int SnowSystem::PARALLEL_MIN_FLAKES;
+
+SnowSystem::SnowSystem(int flakeCount, int screenWidth, int screenHeight, int simulationThreads)
     : numFlakes(flakeCount)
+    , activeFlakes(flakeCount)
+    , rotationMinRadius(0)
     , screenWidth(screenWidth)
     , screenHeight(screenHeight)
     , renderer(nullptr)
-    , snowTexSmall(nullptr)
-    , snowTexMedium(nullptr)
-    , snowTexLarge(nullptr)
+    , snowAtlas(nullptr)
+    , flakeRects{}
+    , atlasWidth(0)
+    , atlasHeight(0)
     , rng(std::random_device{}())
+    , frontFrame(0)
+    , cpuCharge(MemoryPool::SNOW, MemoryKind::CPU)
+    , gpuCharge(MemoryPool::SNOW, MemoryKind::GPU)
+    , currentStep{}
+    , nextSlot(0)
+    , stepsRemaining(0)
+    , stepPending(false)
+    , stopping(false)
+    , simulationThreads(std::max(0, simulationThreads))
 {
     initialized = false;
-    snowflakes.reserve(numFlakes);
+    particles.reserve(numFlakes);
 }
 
 SnowSystem::~SnowSystem() {
-    if (snowTexSmall) SDL_DestroyTexture(snowTexSmall);
-    if (snowTexMedium) SDL_DestroyTexture(snowTexMedium);
-    if (snowTexLarge) SDL_DestroyTexture(snowTexLarge);
+    stopWorkers();
+    if (snowAtlas) SDL_DestroyTexture(snowAtlas);
+}
+
+void SnowSystem::drawCircle(SDL_Surface* surface, int offsetX, int radius, Uint8 alpha) {
+    // Draw filled circle
+    int centerX = offsetX + radius + 1;
+    int centerY = radius + 1;
+    int radiusSquared = radius * radius;
+    Uint32 color = SDL_MapRGBA(surface->format, 255, 255, 255, alpha);
+
+    for (int y = -radius; y <= radius; ++y) {
+        for (int x = -radius; x <= radius; ++x) {
+            if (x * x + y * y <= radiusSquared) {
+                Uint32* pixel = static_cast<Uint32*>(surface->pixels) + 
+                                (centerY + y) * (surface->pitch / 4) + (centerX + x);
+                *pixel = color;
+            }
+        }
+    }
 }
 
-SDL_Texture* SnowSystem::createCircleTexture(int radius, Uint8 alpha) {
-    const int diameter = radius * 2 + 2;
+SDL_Texture* SnowSystem::createAtlasTexture() {
+    struct FlakeSprite { int radius; Uint8 alpha; };
+    const FlakeSprite sprites[3] = { {2, 200}, {3, 220}, {4, 240} };
+    const int padding = 1; // Keeps linear filtering from bleeding between sprites
+
+    // Lay the sprites out left to right
+    atlasWidth = padding;
+    atlasHeight = 0;
+    for (int i = 0; i < 3; ++i) {
+        const int diameter = sprites[i].radius * 2 + 2;
+        flakeRects[i] = { atlasWidth, 0, diameter, diameter };
+        atlasWidth += diameter + padding;
+        atlasHeight = std::max(atlasHeight, diameter);
+    }
+
     SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(
-        0, diameter, diameter, 32, SDL_PIXELFORMAT_RGBA32
+        0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32
     );
     
     if (!surface) {
@@ -39,19 +84,8 @@ SDL_Texture* SnowSystem::createCircleTexture(int radius, Uint8 alpha) {
     SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
     SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 0, 0, 0, 0));
 
-    // Draw filled circle
-    int centerX = radius + 1;
-    int centerY = radius + 1;
-    int radiusSquared = radius * radius;
-
-    for (int y = -radius; y <= radius; ++y) {
-        for (int x = -radius; x <= radius; ++x) {
-            if (x * x + y * y <= radiusSquared) {
-                Uint32* pixel = static_cast<Uint32*>(surface->pixels) + 
-                                (centerY + y) * (surface->pitch / 4) + (centerX + x);
-                *pixel = SDL_MapRGBA(surface->format, 255, 255, 255, alpha);
-            }
-        }
+    for (int i = 0; i < 3; ++i) {
+        drawCircle(surface, flakeRects[i].x, sprites[i].radius, sprites[i].alpha);
     }
 
     SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
@@ -66,7 +100,7 @@ SDL_Texture* SnowSystem::createCircleTexture(int radius, Uint8 alpha) {
     return texture;
 }
 
-Snowflake SnowSystem::createSnowflake() {
+void SnowSystem::createSnowflake(size_t i) {
     std::uniform_real_distribution<float> xDist(-50.0f, screenWidth + 50.0f);
     std::uniform_real_distribution<float> yDist(-50.0f, screenHeight + 50.0f);
     std::uniform_real_distribution<float> speedDist(0.5f, 1.5f);
@@ -76,23 +110,64 @@ Snowflake SnowSystem::createSnowflake() {
     std::uniform_int_distribution<int> radiusDist(2, 4);
     std::uniform_real_distribution<float> depthDist(-1.0f, 1.0f);
 
-    return Snowflake{
-        xDist(rng),
-        yDist(rng),
-        speedDist(rng),
-        driftDist(rng),
-        angleDist(rng),
-        angleVelDist(rng),
-        radiusDist(rng),
-        depthDist(rng)
-    };
+    particles.x[i] = xDist(rng);
+    particles.y[i] = yDist(rng);
+    particles.speed[i] = speedDist(rng);
+    particles.drift[i] = driftDist(rng);
+    particles.angle[i] = angleDist(rng);
+    particles.angleVel[i] = angleVelDist(rng);
+    particles.radius[i] = static_cast<uint8_t>(radiusDist(rng));
+    particles.boundary[i] = particles.radius[i] * 2.0f + 50.0f;
+    particles.depth[i] = depthDist(rng);
 }
 
-void SnowSystem::resetSnowflake(Snowflake& snow) {
-    std::uniform_real_distribution<float> xDist(-50.0f, screenWidth + 50.0f);
-    
-    snow.x = xDist(rng);
-    snow.y = -snow.radius * 2.0f - 50.0f;
+void SnowSystem::sortByProminence() {
+    std::vector<size_t> order(particles.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this](size_t a, size_t b) {
+                         // Sprite radius sets both size and alpha; speed breaks ties
+                         if (particles.radius[a] != particles.radius[b]) {
+                             return particles.radius[a] > particles.radius[b];
+                         }
+                         return particles.speed[a] > particles.speed[b];
+                     });
+
+    SnowParticles sorted;
+    sorted.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const size_t from = order[i];
+        sorted.x[i] = particles.x[from];
+        sorted.y[i] = particles.y[from];
+        sorted.speed[i] = particles.speed[from];
+        sorted.drift[i] = particles.drift[from];
+        sorted.angle[i] = particles.angle[from];
+        sorted.angleVel[i] = particles.angleVel[from];
+        sorted.boundary[i] = particles.boundary[from];
+        sorted.depth[i] = particles.depth[from];
+        sorted.radius[i] = particles.radius[from];
+    }
+    particles = std::move(sorted);
+}
+
+void SnowSystem::setQuality(const SnowQuality& quality) {
+    activeFlakes = std::clamp(quality.flakes, 0, numFlakes);
+    rotationMinRadius = quality.rotationMinRadius;
+}
+
+void SnowSystem::seed(uint32_t value) {
+    rng.seed(value);
+}
+
+void SnowSystem::recreateTextures() {
+    if (!renderer) {
+        return;
+    }
+    if (snowAtlas) SDL_DestroyTexture(snowAtlas);
+    snowAtlas = createAtlasTexture();
+    gpuCharge.resize(snowAtlas ? static_cast<size_t>(atlasWidth) * atlasHeight * 4 : 0);
 }
 
 void SnowSystem::initialize(SDL_Renderer* r) {
@@ -102,60 +177,158 @@ void SnowSystem::initialize(SDL_Renderer* r) {
         return;
     }
 
-    // Create base textures
-    snowTexSmall = createCircleTexture(2, 200);
-    snowTexMedium = createCircleTexture(3, 220);
-    snowTexLarge = createCircleTexture(4, 240);
+    // Create the sprite atlas
+    snowAtlas = createAtlasTexture();
 
-    if (!snowTexSmall || !snowTexMedium || !snowTexLarge) {
+    if (!snowAtlas) {
         LOG_ERROR("Failed to create snowflake textures");
         return;
     }
 
     // Create snowflakes
-    snowflakes.clear();
+    particles.resize(numFlakes);
     for (int i = 0; i < numFlakes; ++i) {
-        snowflakes.push_back(createSnowflake());
+        createSnowflake(i);
+    }
+    sortByProminence(); // The active prefix loses the least visible flakes first
+
+    chunkRngs.resize((particles.size() + CHUNK_FLAKES - 1) / CHUNK_FLAKES);
+    for (SnowRng& chunkRng : chunkRngs) {
+        chunkRng.seed(rng());
+    }
+
+    // Both buffers start with the initial field
+    for (SnowFrame& frame : frames) {
+        frame.x = particles.x;
+        frame.y = particles.y;
+        frame.angle = particles.angle;
+        frame.count = activeFlakes;
+    }
+    // Measured from the arrays, so a new field is charged without touching this
+    size_t frameBytes = 0;
+    for (const SnowFrame& frame : frames) {
+        frameBytes += frame.x.capacity() * sizeof(frame.x[0]) + frame.y.capacity() * sizeof(frame.y[0]) +
+                      frame.angle.capacity() * sizeof(frame.angle[0]);
+    }
+    cpuCharge.resize(particles.memoryBytes() + frameBytes + chunkRngs.capacity() * sizeof(SnowRng));
+    gpuCharge.resize(static_cast<size_t>(atlasWidth) * atlasHeight * 4);
+
+    // A field below PARALLEL_MIN_FLAKES is always stepped by one worker, so
+    // do not start others that would only sit idle
+    if (numFlakes < PARALLEL_MIN_FLAKES) {
+        simulationThreads = std::min(simulationThreads, 1);
+    }
+    for (int i = 0; i < simulationThreads; ++i) {
+        workers.emplace_back(&SnowSystem::workerLoop, this);
     }
 
     initialized = true;
-    LOG_INFO("Snow system initialized with %d flakes", numFlakes);
+    LOG_INFO("Snow system initialized with %d flakes, %d active (%s update kernel, %d simulation threads)",
+             numFlakes, activeFlakes, snowKernelName(), simulationThreads);
 }
 
-void SnowSystem::update() {
-    if (!initialized) {
-        return;
+void SnowSystem::simulateChunks(const StepJob& job, int share) {
+    const size_t active = static_cast<size_t>(job.active);
+    const size_t chunks = (active + CHUNK_FLAKES - 1) / CHUNK_FLAKES;
+    SnowFrame& out = *job.output;
+    for (size_t c = static_cast<size_t>(share); c < chunks; c += static_cast<size_t>(job.threads)) {
+        const size_t begin = c * CHUNK_FLAKES;
+        const size_t end = std::min(begin + CHUNK_FLAKES, active);
+        updateSnowParticles(particles, begin, end, job.params, chunkRngs[c]);
+        std::copy(particles.x.begin() + begin, particles.x.begin() + end, out.x.begin() + begin);
+        std::copy(particles.y.begin() + begin, particles.y.begin() + end, out.y.begin() + begin);
+        std::copy(particles.angle.begin() + begin, particles.angle.begin() + end, out.angle.begin() + begin);
     }
+    if (share == 0) {
+        out.count = job.active;
+    }
+}
 
-    std::uniform_real_distribution<float> driftChangeDist(-0.02f, 0.02f);
-
-    for (auto& snow : snowflakes) {
-        // Apply gravity
-        snow.y += snow.speed;
+void SnowSystem::startStep(const SnowKernelParams& params) {
+    const int chunks = static_cast<int>((static_cast<size_t>(activeFlakes) + CHUNK_FLAKES - 1) / CHUNK_FLAKES);
+    const int threads = activeFlakes >= PARALLEL_MIN_FLAKES
+        ? std::max(1, std::min(static_cast<int>(workers.size()), chunks)) : 1;
+    {
+        std::lock_guard<std::mutex> lock(stepMutex);
+        currentStep = StepJob{params, activeFlakes, threads, &frames[1 - frontFrame]};
+        nextSlot = 0;
+        stepsRemaining = threads;
+    }
+    if (threads == 1) {
+        stepStart.notify_one();
+    } else {
+        stepStart.notify_all();
+    }
+    stepPending = true;
+}
 
-        // Update horizontal drift
-        snow.drift = std::clamp(snow.drift + driftChangeDist(rng), -0.5f, 0.5f);
-        snow.x += snow.drift;
+void SnowSystem::waitForStep() {
+    if (!stepPending) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(stepMutex);
+    stepDone.wait(lock, [this]() { return stepsRemaining == 0; });
+    frontFrame = 1 - frontFrame;
+    stepPending = false;
+}
 
-        // Wrap horizontally
-        float boundary = snow.radius * 2.0f + 50.0f;
-        if (snow.x < -boundary) {
-            snow.x = screenWidth + boundary;
-        } else if (snow.x > screenWidth + boundary) {
-            snow.x = -boundary;
+void SnowSystem::workerLoop() {
+    std::unique_lock<std::mutex> lock(stepMutex);
+    while (true) {
+        stepStart.wait(lock, [this]() { return stopping || nextSlot < currentStep.threads; });
+        if (stopping) {
+            return;
         }
+        const int share = nextSlot++;
+        const StepJob job = currentStep;
+        lock.unlock();
+
+        simulateChunks(job, share);
 
-        // Reset if off bottom of screen
-        if (snow.y > screenHeight + boundary) {
-            resetSnowflake(snow);
+        lock.lock();
+        if (--stepsRemaining == 0) {
+            stepDone.notify_one();
         }
+    }
+}
 
-        // Rotate
-        snow.angle = std::fmod(snow.angle + snow.angleVel, 360.0f);
-        if (snow.angle < 0.0f) {
-            snow.angle += 360.0f;
+void SnowSystem::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(stepMutex);
+        stopping = true;
+    }
+    stepStart.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
         }
     }
+    workers.clear();
+}
+
+void SnowSystem::update(float dt) {
+    if (!initialized) {
+        return;
+    }
+    waitForStep(); // Publish the step started by the previous call
+    if (dt <= 0.0f) {
+        return;
+    }
+
+    // Scale per-frame motion by elapsed time so the animation looks the same at any frame rate.
+    // Drift is a random walk, so its per-step noise scales with the square root of the step.
+    SnowKernelParams params;
+    params.frames = dt * REFERENCE_FPS;
+    params.driftNoise = 0.02f * std::sqrt(params.frames);
+    params.screenWidth = static_cast<float>(screenWidth);
+    params.screenHeight = static_cast<float>(screenHeight);
+
+    if (workers.empty()) {
+        simulateChunks(StepJob{params, activeFlakes, 1, &frames[1 - frontFrame]}, 0);
+        frontFrame = 1 - frontFrame;
+        return;
+    }
+    startStep(params);
 }
 
 void SnowSystem::draw(SDL_Renderer* renderer) {
@@ -163,28 +336,112 @@ void SnowSystem::draw(SDL_Renderer* renderer) {
         return;
     }
 
-    if (!renderer || snowflakes.empty()) {
+    const SnowFrame& frame = frames[frontFrame];
+    if (!renderer || frame.count == 0) {
         return;
     }
 
-    SDL_Texture* textures[] = { snowTexSmall, snowTexMedium, snowTexLarge };
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (!geometryFailed) {
+        drawBatched(renderer, frame);
+        return;
+    }
+#endif
+    drawPerFlake(renderer, frame);
+}
 
-    for (const auto& snow : snowflakes) {
-        int texIndex = snow.radius - 2;
-        if (texIndex < 0 || texIndex > 2) continue;
+void SnowSystem::drawBatched(SDL_Renderer* renderer, const SnowFrame& frame) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // Sine/cosine table at one-degree resolution; flakes are tiny so this is exact enough
+    static float sinTable[360];
+    static float cosTable[360];
+    static bool tablesReady = false;
+    if (!tablesReady) {
+        for (int deg = 0; deg < 360; ++deg) {
+            float rad = deg * static_cast<float>(M_PI) / 180.0f;
+            sinTable[deg] = std::sin(rad);
+            cosTable[deg] = std::cos(rad);
+        }
+        tablesReady = true;
+    }
+
+    const size_t count = static_cast<size_t>(frame.count);
+
+    // Index buffer only depends on the flake count
+    if (indices.size() != count * 6) {
+        indices.resize(count * 6);
+        for (size_t i = 0; i < count; ++i) {
+            const int base = static_cast<int>(i * 4);
+            int* quad = &indices[i * 6];
+            quad[0] = base;     quad[1] = base + 1; quad[2] = base + 2;
+            quad[3] = base + 2; quad[4] = base + 3; quad[5] = base;
+        }
+    }
+    vertices.resize(count * 4);
+
+    const float invW = 1.0f / atlasWidth;
+    const float invH = 1.0f / atlasHeight;
+    const SDL_Color white = {255, 255, 255, 255};
 
-        SDL_Texture* texture = textures[texIndex];
-        int texW, texH;
-        SDL_QueryTexture(texture, nullptr, nullptr, &texW, &texH);
+    for (size_t i = 0; i < count; ++i) {
+        const SDL_Rect& src = flakeRects[std::clamp(particles.radius[i] - 2, 0, 2)];
+        const float hw = src.w * 0.5f;
+        const float hh = src.h * 0.5f;
 
+        // Rotate the quad corners around the flake centre (clockwise, like SDL_RenderCopyEx)
+        float c = 1.0f;
+        float s = 0.0f;
+        if (isRotated(i)) {
+            const int deg = static_cast<int>(frame.angle[i]) % 360;
+            c = cosTable[deg];
+            s = sinTable[deg];
+        }
+        const float cx = frame.x[i];
+        const float cy = frame.y[i];
+        const float ax = hw * c, ay = hw * s;    // Rotated half-width axis
+        const float bx = -hh * s, by = hh * c;   // Rotated half-height axis
+
+        const float u0 = src.x * invW, u1 = (src.x + src.w) * invW;
+        const float v0 = src.y * invH, v1 = (src.y + src.h) * invH;
+
+        SDL_Vertex* v = &vertices[i * 4];
+        v[0] = { { cx - ax - bx, cy - ay - by }, white, { u0, v0 } };
+        v[1] = { { cx + ax - bx, cy + ay - by }, white, { u1, v0 } };
+        v[2] = { { cx + ax + bx, cy + ay + by }, white, { u1, v1 } };
+        v[3] = { { cx - ax + bx, cy - ay + by }, white, { u0, v1 } };
+    }
+
+    if (SDL_RenderGeometry(renderer, snowAtlas, vertices.data(), static_cast<int>(vertices.size()),
+                           indices.data(), static_cast<int>(indices.size())) != 0) {
+        LOG_WARNING("SDL_RenderGeometry failed (%s), falling back to per-flake drawing", SDL_GetError());
+        geometryFailed = true;
+        drawPerFlake(renderer, frame);
+    }
+#else
+    drawPerFlake(renderer, frame);
+#endif
+}
+
+void SnowSystem::drawPerFlake(SDL_Renderer* renderer, const SnowFrame& frame) {
+    // Fallback for SDL < 2.0.18 or renderers without geometry support
+    const size_t count = static_cast<size_t>(frame.count);
+    for (size_t i = 0; i < count; ++i) {
+        int texIndex = particles.radius[i] - 2;
+        if (texIndex < 0 || texIndex > 2) continue;
+
+        const SDL_Rect& src = flakeRects[texIndex];
         SDL_Rect destRect = {
-            static_cast<int>(snow.x - texW / 2.0f),
-            static_cast<int>(snow.y - texH / 2.0f),
-            texW,
-            texH
+            static_cast<int>(frame.x[i] - src.w / 2.0f),
+            static_cast<int>(frame.y[i] - src.h / 2.0f),
+            src.w,
+            src.h
         };
 
-        SDL_RenderCopyEx(renderer, texture, nullptr, &destRect, 
-                        snow.angle, nullptr, SDL_FLIP_NONE);
+        if (isRotated(i)) {
+            SDL_RenderCopyEx(renderer, snowAtlas, &src, &destRect,
+                            frame.angle[i], nullptr, SDL_FLIP_NONE);
+        } else {
+            SDL_RenderCopy(renderer, snowAtlas, &src, &destRect);
+        }
     }
-}
\ No newline at end of file
+}
@@ -1,50 +1,129 @@
 #ifndef SNOW_SYSTEM_H
 #define SNOW_SYSTEM_H
 
+#include "snow_kernel.h"
+#include "quality_governor.h"
+#include "memory_budget.h"
 #include <SDL2/SDL.h>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <random>
 
-struct Snowflake {
-    float x, y;
-    float speed;
-    float drift;
-    float angle;
-    float angleVel;
-    int radius;
-    float depth;
-};
-
 class SnowSystem {
 public:
-    SnowSystem(int flakeCount, int screenWidth, int screenHeight);
+    // flakeCount is the capacity; all flakes are active until setQuality().
+    // With simulationThreads > 0 the step for the next frame runs on worker
+    // threads while the current one is drawn (see update()).
+    SnowSystem(int flakeCount, int screenWidth, int screenHeight, int simulationThreads = 0);
     ~SnowSystem();
 
+    // Reseed before initialize() for a reproducible flake field (headless replay)
+    void seed(uint32_t value);
     void initialize(SDL_Renderer* renderer);
-    void update();
+    // Advance the simulation by dt seconds of real time. Threaded: waits for
+    // the step started by the previous call, makes its result the one draw()
+    // shows, and starts the next step, so the picture is one step behind.
+    void update(float dt);
+    // Draws the latest finished step; never touches the simulation state
     void draw(SDL_Renderer* renderer);
 
+    // Level of detail: flakes are kept most visible first (large, opaque and
+    // fast before small, faint and slow), so lowering the active count drops
+    // the least noticeable ones. Takes effect on the next update/draw.
+    void setQuality(const SnowQuality& quality);
+    int getActiveCount() const { return activeFlakes; }
+
+    // Rebuild the sprite atlas after the renderer lost its textures
+    void recreateTextures();
+
 private:
+    // Flake speeds are tuned in pixels per frame at this rate
+    static constexpr float REFERENCE_FPS = 60.0f;
+
+    // Flakes are simulated in fixed chunks with their own RNG, so the result
+    // does not depend on how chunks are spread over threads
+    static constexpr size_t CHUNK_FLAKES = 256;
+    // Below this many active flakes one worker is faster than waking several
+    static constexpr int PARALLEL_MIN_FLAKES = 2048;
+
     // Configuration
     int numFlakes;
+    int activeFlakes;
+    int rotationMinRadius;    // Smaller flakes are drawn unrotated
     int screenWidth;
     int screenHeight;
 
-    // Rendering resources
+    // Rendering resources: the small/medium/large flake sprites share one atlas
+    // texture so the whole field can be submitted as a single geometry batch
     SDL_Renderer* renderer;
-    SDL_Texture* snowTexSmall;
-    SDL_Texture* snowTexMedium;
-    SDL_Texture* snowTexLarge;
+    SDL_Texture* snowAtlas;
+    SDL_Rect flakeRects[3];   // Atlas regions for radius 2, 3 and 4
+    int atlasWidth;
+    int atlasHeight;
 
-    // Snowflake data
-    std::vector<Snowflake> snowflakes;
-    std::mt19937 rng;
+    // Per-frame batch buffers, reused between frames
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    bool geometryFailed = false;
+#endif
+
+    // Snowflake data (structure of arrays, see snow_kernel.h). Owned by the
+    // simulation; while a step runs only the workers touch it. radius is
+    // fixed after initialize() and read by draw().
+    SnowParticles particles;
+    std::mt19937 rng;         // Initial placement and chunk generator seeds
+    std::vector<SnowRng> chunkRngs;   // Per-frame draws inside the update kernel
     bool initialized = false;
 
+    // What draw() needs from a finished step. Double-buffered: draw() reads
+    // frames[frontFrame] while a step writes the other one.
+    struct SnowFrame {
+        std::vector<float> x, y, angle;
+        int count = 0;
+    };
+    SnowFrame frames[2];
+    int frontFrame;
+
+    MemoryCharge cpuCharge;   // Particles and both frames, in MemoryPool::SNOW
+    MemoryCharge gpuCharge;   // Sprite atlas
+
+    // One step: the chunks of [0, active) are split across threads
+    struct StepJob {
+        SnowKernelParams params;
+        int active;
+        int threads;          // Workers taking part
+        SnowFrame* output;
+    };
+
+    // Frame fence between update() and the workers
+    std::vector<std::thread> workers;
+    std::mutex stepMutex;
+    std::condition_variable stepStart;
+    std::condition_variable stepDone;
+    StepJob currentStep;
+    int nextSlot;             // Next share of currentStep a woken worker claims
+    int stepsRemaining;       // Shares of the current step still running
+    bool stepPending;         // Started and not yet picked up by update() (main thread)
+    bool stopping;
+    int simulationThreads;
+
     // Helper functions
-    SDL_Texture* createCircleTexture(int radius, Uint8 alpha);
-    Snowflake createSnowflake();
-    void resetSnowflake(Snowflake& snow);
+    SDL_Texture* createAtlasTexture();
+    void drawCircle(SDL_Surface* surface, int offsetX, int radius, Uint8 alpha);
+    void createSnowflake(size_t index);
+    void sortByProminence();
+    bool isRotated(size_t index) const { return particles.radius[index] >= rotationMinRadius; }
+    void simulateChunks(const StepJob& job, int share);  // Chunks share, share + threads, ...
+    void startStep(const SnowKernelParams& params);
+    void waitForStep();
+    void workerLoop();
+    void stopWorkers();
+    void drawBatched(SDL_Renderer* renderer, const SnowFrame& frame);
+    void drawPerFlake(SDL_Renderer* renderer, const SnowFrame& frame);
 };
 
 #endif // SNOW_SYSTEM_H
\ No newline at end of file
@@ -0,0 +1,114 @@
+// text_shadow.cpp
+#include "text_shadow.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// One box pass along a line of count samples, stride apart
+void blurLine(uint8_t* line, int count, int stride, int radius, std::vector<uint8_t>& copy) {
+    copy.resize(count);
+    for (int i = 0; i < count; ++i) {
+        copy[i] = line[i * stride];
+    }
+
+    const int window = radius * 2 + 1;
+    int sum = 0;
+    for (int i = 0; i < std::min(radius, count); ++i) {
+        sum += copy[i];
+    }
+    for (int i = 0; i < count; ++i) {
+        const int enter = i + radius;
+        const int leave = i - radius - 1;
+        if (enter < count) sum += copy[enter];
+        if (leave >= 0) sum -= copy[leave];
+        line[i * stride] = static_cast<uint8_t>((sum + window / 2) / window);
+    }
+}
+
+} // namespace
+
+void boxBlur8(uint8_t* plane, int width, int height, int radius) {
+    if (radius <= 0 || width <= 0 || height <= 0) {
+        return;
+    }
+    std::vector<uint8_t> copy;
+    for (int y = 0; y < height; ++y) {
+        blurLine(plane + static_cast<size_t>(y) * width, width, 1, radius, copy);
+    }
+    for (int x = 0; x < width; ++x) {
+        blurLine(plane + x, height, width, radius, copy);
+    }
+}
+
+SDL_Surface* bakeTextShadow(SDL_Surface* glyphs, const TextShadowParams& params) {
+    if (!glyphs) {
+        return nullptr;
+    }
+
+    SDL_Surface* source = glyphs;
+    if (glyphs->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        source = SDL_ConvertSurfaceFormat(glyphs, SDL_PIXELFORMAT_ARGB8888, 0);
+        if (!source) {
+            return nullptr;
+        }
+    }
+
+    const int pad = params.padding();
+    const int width = source->w + pad * 2 + params.offset;
+    const int height = source->h + pad * 2 + params.offset;
+    SDL_Surface* out = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!out) {
+        if (source != glyphs) SDL_FreeSurface(source);
+        return nullptr;
+    }
+
+    if (SDL_MUSTLOCK(source)) SDL_LockSurface(source);
+
+    // Shadow coverage: glyph alpha shifted by the offset, then blurred
+    std::vector<uint8_t> shadow(static_cast<size_t>(width) * height, 0);
+    for (int y = 0; y < source->h; ++y) {
+        const Uint32* row = reinterpret_cast<const Uint32*>(
+            static_cast<const uint8_t*>(source->pixels) + static_cast<size_t>(y) * source->pitch);
+        uint8_t* dst = &shadow[static_cast<size_t>(y + pad + params.offset) * width + pad + params.offset];
+        for (int x = 0; x < source->w; ++x) {
+            dst[x] = static_cast<uint8_t>(row[x] >> 24);
+        }
+    }
+    for (int pass = 0; pass < params.passes; ++pass) {
+        boxBlur8(shadow.data(), width, height, params.radius);
+    }
+
+    // Glyphs over the shadow, straight alpha: a = g + s(1 - g), rgb = c * g / a
+    for (int y = 0; y < height; ++y) {
+        Uint32* dst = reinterpret_cast<Uint32*>(static_cast<uint8_t*>(out->pixels) + static_cast<size_t>(y) * out->pitch);
+        const uint8_t* shadowRow = &shadow[static_cast<size_t>(y) * width];
+        const int sy = y - pad;
+        const Uint32* srcRow = (sy >= 0 && sy < source->h)
+            ? reinterpret_cast<const Uint32*>(static_cast<const uint8_t*>(source->pixels) + static_cast<size_t>(sy) * source->pitch)
+            : nullptr;
+
+        for (int x = 0; x < width; ++x) {
+            const int s = shadowRow[x] * params.alpha / 255;
+            const int sx = x - pad;
+            const Uint32 glyph = (srcRow && sx >= 0 && sx < source->w) ? srcRow[sx] : 0;
+            const int g = static_cast<int>(glyph >> 24);
+
+            const int a = g + s * (255 - g) / 255;
+            if (a == 0) {
+                dst[x] = 0;
+                continue;
+            }
+            const int r = static_cast<int>((glyph >> 16) & 0xFF) * g / a;
+            const int gr = static_cast<int>((glyph >> 8) & 0xFF) * g / a;
+            const int b = static_cast<int>(glyph & 0xFF) * g / a;
+            dst[x] = (static_cast<Uint32>(a) << 24) | (static_cast<Uint32>(r) << 16) |
+                     (static_cast<Uint32>(gr) << 8) | static_cast<Uint32>(b);
+        }
+    }
+
+    if (SDL_MUSTLOCK(source)) SDL_UnlockSurface(source);
+    if (source != glyphs) SDL_FreeSurface(source);
+    return out;
+}
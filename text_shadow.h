@@ -0,0 +1,30 @@
+// text_shadow.h
+#ifndef TEXT_SHADOW_H
+#define TEXT_SHADOW_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+// Soft drop shadow baked under rendered text, so a shadowed string is one
+// texture and one SDL_RenderCopy with no colour/alpha mod changes.
+struct TextShadowParams {
+    int offset;     // Shadow shift right and down, pixels
+    int radius;     // Box blur radius per pass
+    int passes;     // Box blur passes (2 ~ tent, 3 ~ gaussian)
+    Uint8 alpha;    // Shadow opacity under fully covered pixels
+
+    // Pixels the baked image extends past the glyph box on the left and top;
+    // the right and bottom extend by padding() + offset
+    int padding() const { return radius * passes; }
+};
+
+// Returns a new ARGB8888 surface of (w + 2 * padding + offset) x (h + 2 * padding + offset)
+// with glyphs (straight alpha, e.g. from TTF_RenderUTF8_Blended) at
+// (padding, padding) over a blurred black copy of their coverage, or nullptr.
+// glyphs is not modified.
+SDL_Surface* bakeTextShadow(SDL_Surface* glyphs, const TextShadowParams& params);
+
+// In-place separable box blur of an 8-bit plane; pixels outside count as 0
+void boxBlur8(uint8_t* plane, int width, int height, int radius);
+
+#endif // TEXT_SHADOW_H
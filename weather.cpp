@@ -1,14 +1,22 @@
 // weather.cpp
 #include "weather.h"
 #include "config.h"
-#include <string>
-#include <sstream>
+#include "logger.h"
+#include <array>
 #include <cmath>
-#include <map>
+#include <deque>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 
-// Weather code descriptions using string_view for efficiency
-const std::map<int, std::string_view> WEATHER_CODE_RU = {
+namespace {
+
+struct WeatherCodeName {
+    int code;
+    std::string_view name;
+};
+
+constexpr WeatherCodeName WEATHER_CODE_NAMES[] = {
     {0, "Ясно"},
     {1, "Редкие облака"},
     {2, "Переменная облачность"},
@@ -39,60 +47,58 @@ const std::map<int, std::string_view> WEATHER_CODE_RU = {
     {99, "Град с грозой"}
 };
 
-// Windspeed type descriptions using string_view
-std::string_view getWindspeedType(double windspeed) {
-    if (windspeed < 1) {
-        return "штиль";
-    } else if (windspeed <= 5) {
-        return "ветерок";
-    } else if (windspeed <= 10) {
-        return "ветер";
-    } else if (windspeed <= 15) {
-        return "сильный ветер";
-    } else if (windspeed <= 20) {
-        return "шквальный ветер";
-    } else {
-        return "ураган";
+constexpr int WMO_CODE_COUNT = 100;
+
+// Weather code descriptions indexed by WMO code; empty for unused codes
+constexpr std::array<std::string_view, WMO_CODE_COUNT> makeWeatherCodeTable() {
+    std::array<std::string_view, WMO_CODE_COUNT> table{};
+    for (const auto& entry : WEATHER_CODE_NAMES) {
+        table[entry.code] = entry.name;
     }
+    return table;
 }
 
-// Static cache for weather descriptions
-static std::unordered_map<WeatherKey, std::string, WeatherKeyHash> weatherCache;
-static const size_t MAX_CACHE_SIZE = 1000;
+constexpr std::array<std::string_view, WMO_CODE_COUNT> WEATHER_CODE_RU = makeWeatherCodeTable();
+static_assert(WEATHER_CODE_RU[73] == "Снегопад", "WMO table");
 
-std::string getWeatherDescription(double temperature, int weathercode, double windspeed, bool showWindspeed) {
-    // Round values for cache key
-    int roundedTemp = static_cast<int>(std::round(temperature));
-    int roundedWind = static_cast<int>(std::round(windspeed));
-    
-    // Create cache key
-    WeatherKey key{roundedTemp, weathercode, roundedWind, showWindspeed};
-    
-    // Check cache
-    auto it = weatherCache.find(key);
-    if (it != weatherCache.end()) {
-        return it->second;
-    }
-    
-    // Clean cache if too large
-    if (weatherCache.size() >= MAX_CACHE_SIZE) {
-        weatherCache.clear();
-    }
-    
-    // Build description
+// Windspeed types by upper bound (inclusive, except the first which is exclusive)
+struct WindType {
+    double maxSpeed;
+    std::string_view name;
+};
+
+constexpr WindType WIND_TYPES[] = {
+    {1, "штиль"},
+    {5, "ветерок"},
+    {10, "ветер"},
+    {15, "сильный ветер"},
+    {20, "шквальный ветер"},
+};
+constexpr std::string_view STRONGEST_WIND = "ураган";
+
+// Interned descriptions. Entries live in a deque, so views stay valid for the
+// life of the process; the table stops growing at MAX_INTERNED entries, and
+// later keys get a per-thread buffer instead (see getWeatherDescription()).
+constexpr size_t MAX_INTERNED = 1024;
+
+std::mutex internMutex;
+std::deque<std::string> internedStorage;
+std::unordered_map<WeatherKey, std::string_view, WeatherKeyHash> interned;
+
+std::string buildDescription(int roundedTemp, int weathercode, double windspeed, int roundedWind, bool showWindspeed) {
     std::string description;
-    description.reserve(50); // Pre-allocate space for typical description length
-    
+    description.reserve(64);
+
     // Add temperature
     description += std::to_string(roundedTemp);
     description += "°C";
-    
+
     // Add weather code description
-    if (auto it = WEATHER_CODE_RU.find(weathercode); it != WEATHER_CODE_RU.end()) {
+    if (weathercode >= 0 && weathercode < WMO_CODE_COUNT && !WEATHER_CODE_RU[weathercode].empty()) {
         description += ", ";
-        description += it->second;
+        description += WEATHER_CODE_RU[weathercode];
     }
-    
+
     // Add windspeed if requested
     if (showWindspeed) {
         description += ", ";
@@ -103,8 +109,51 @@ std::string getWeatherDescription(double temperature, int weathercode, double wi
             description += " м/с";
         }
     }
-    
-    // Cache and return
-    weatherCache[key] = description;
     return description;
-}
\ No newline at end of file
+}
+
+} // namespace
+
+std::string_view getWindspeedType(double windspeed) {
+    if (windspeed < WIND_TYPES[0].maxSpeed) {
+        return WIND_TYPES[0].name;
+    }
+    for (size_t i = 1; i < sizeof(WIND_TYPES) / sizeof(WIND_TYPES[0]); ++i) {
+        if (windspeed <= WIND_TYPES[i].maxSpeed) {
+            return WIND_TYPES[i].name;
+        }
+    }
+    return STRONGEST_WIND;
+}
+
+std::string_view getWeatherDescription(double temperature, int weathercode, double windspeed, bool showWindspeed) {
+    // Round values for the key
+    int roundedTemp = static_cast<int>(std::round(temperature));
+    int roundedWind = static_cast<int>(std::round(windspeed));
+    WeatherKey key{roundedTemp, weathercode, roundedWind, showWindspeed};
+
+    std::lock_guard<std::mutex> lock(internMutex);
+    auto it = interned.find(key);
+    if (it != interned.end()) {
+        return it->second;
+    }
+
+    std::string description = buildDescription(roundedTemp, weathercode, windspeed, roundedWind, showWindspeed);
+    if (interned.size() >= MAX_INTERNED) {
+        // Not reachable with real weather; keep views stable rather than evicting
+        // (valid until this thread's next call)
+        static bool warned = false;
+        static thread_local std::string overflow;
+        if (!warned) {
+            LOG_WARNING("Weather description table full (%zu entries)", MAX_INTERNED);
+            warned = true;
+        }
+        overflow = std::move(description);
+        return overflow;
+    }
+
+    internedStorage.push_back(std::move(description));
+    std::string_view view = internedStorage.back();
+    interned.emplace(key, view);
+    return view;
+}
@@ -31,10 +31,13 @@ struct WeatherKeyHash {
     }
 };
 
-// Get weather description with caching
-std::string getWeatherDescription(double temperature, int weathercode, double windspeed, bool showWindspeed = true);
+// Get weather description. Descriptions are interned, and the view normally
+// stays valid for the life of the process. Once the table is full (more keys
+// than real weather produces) the view is only valid until this thread's next
+// call, so copy it rather than keeping it around. Thread-safe.
+std::string_view getWeatherDescription(double temperature, int weathercode, double windspeed, bool showWindspeed = true);
 
-// Get windspeed type description (now returns string_view for efficiency)
+// Get windspeed type description (view of a static string)
 std::string_view getWindspeedType(double windspeed);
 
 #endif // WEATHER_H
\ No newline at end of file
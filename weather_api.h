@@ -4,21 +4,48 @@
 
 #include <string>
 #include <mutex>
-#include <thread>
 #include <atomic>
-#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+
+class HTTPClient;
+class IOExecutor;
+
+// Hourly series from the forecast, starting at the hour in startTime.
+// Fixed capacity keeps WeatherData a flat, allocation-free copy.
+struct HourlyForecast {
+    static constexpr int CAPACITY = 48;
+
+    time_t startTime;                      // Local time of the first entry (0 if unknown)
+    int count;                             // Valid entries in the first two arrays
+    float apparentTemperature[CAPACITY];   // °C; added to the prefetch prompt
+    float precipitation[CAPACITY];         // mm; NaN where the API returned null
+
+    // Conditions per hour, for advice prefetching; same null handling
+    int conditionsCount;                   // Valid entries in the arrays below
+    float temperature[CAPACITY];           // °C
+    float windspeed[CAPACITY];             // m/s
+    int weathercode[CAPACITY];             // WMO code; -1 where the API returned null
+
+    HourlyForecast()
+        : startTime(0), count(0), apparentTemperature(), precipitation(),
+          conditionsCount(0), temperature(), windspeed(), weathercode() {}
+};
 
 struct WeatherData {
     double temperature;
     int weathercode;
     double windspeed;
+    HourlyForecast hourly;
 
     WeatherData() : temperature(0.0), weathercode(-1), windspeed(0.0) {}
 };
 
 class WeatherAPI {
 public:
-    WeatherAPI();
+    explicit WeatherAPI(IOExecutor& executor);
     ~WeatherAPI();
 
     // Non-blocking weather data access
@@ -27,27 +54,41 @@ public:
     // Check if data has been successfully fetched at least once
     bool isDataValid() const; // <<< Add this declaration
 
+    // Incremented whenever new data is stored; lets callers skip unchanged data without locking
+    uint64_t getDataVersion() const { return dataVersion.load(std::memory_order_acquire); }
+
+    // Offline use (headless replay): take the data from a recorded API response
+    // instead of calling start()
+    bool loadResponse(const std::string& body);
+
     // Control methods
-    void start();  // Start background updates
-    void stop();   // Stop background updates
+    void start();  // Register the periodic update job on the executor
+    void stop();   // Cancel it, aborting a request in flight
+
+    // Called from an executor thread after new data is stored. Set before start().
+    void setUpdateCallback(std::function<void()> callback) { onUpdate = std::move(callback); }
 
 private:
-    static constexpr int UPDATE_INTERVAL = 300;  // 5 minutes in seconds
+    static constexpr int UPDATE_INTERVAL = 300;     // 5 minutes in seconds
+    static constexpr int MAX_RETRY_INTERVAL = 300;  // Failed updates back off from 1 s up to this
 
-    // Thread control
+    // Job control
+    IOExecutor& executor;
+    uint64_t updateJob;
     std::atomic<bool> running;
-    std::thread updateThread;
     mutable std::mutex dataMutex; // Mutex protects currentWeatherData and lastUpdate
-    std::condition_variable updateCV;
 
     // Weather data
     WeatherData currentWeatherData;
     time_t lastUpdate;
     std::atomic<bool> dataInitiallyFetched{false}; // <<< Add this flag, initialize to false
+    std::atomic<uint64_t> dataVersion{0};
+    std::function<void()> onUpdate;
+    std::shared_ptr<HTTPClient> httpClient; // Pooled per-host client
 
     // Internal methods
-    void updateLoop();
-    WeatherData fetchWeatherFromAPI();
+    bool runUpdate();  // One update attempt; false on failure (the executor retries)
+    WeatherData fetchWeatherFromAPI(bool& notModified);
     // bool shouldUpdate() const; // <<< This method will be removed/integrated into updateLoop
 
     // Prevent copying